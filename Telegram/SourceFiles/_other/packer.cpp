@@ -16,6 +16,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 bool BetaChannel = false;
 quint64 AlphaVersion = 0;
 bool OnlyAlphaKey = false;
+QString DeltaBaseDir;
+quint64 DeltaBaseVersion = 0;
 
 const char *PublicKey = "\
 -----BEGIN RSA PUBLIC KEY-----\n\
@@ -137,6 +139,314 @@ int32 *hashSha1(const void *data, uint32 len, void *dest) {
 	return (int32*)sha1To;
 }
 
+namespace {
+
+// Delta package format, read by UnpackUpdate in core/update_checker.cpp.
+constexpr auto kDeltaPackageTag = quint32(0x8DE17A00);
+
+constexpr auto kDeltaBlockSize = 64;
+constexpr auto kDeltaHashMultiplier = quint32(0x01000193);
+constexpr auto kDeltaMinAddSize = 16;
+constexpr auto kDeltaAddTolerance = 32;
+
+enum class PatchOp : quint8 {
+	Copy, // base[offset, offset + length)
+	Insert, // bytes
+	Add, // base[offset, offset + diff.size()) + diff, bytewise
+};
+
+QByteArray countSha1(const QByteArray &data) {
+	auto result = QByteArray(20, Qt::Uninitialized);
+	hashSha1(data.constData(), uint32(data.size()), result.data());
+	return result;
+}
+
+quint32 blockHash(const uchar *from) {
+	auto result = quint32(0);
+	for (auto i = 0; i != kDeltaBlockSize; ++i) {
+		result = result * kDeltaHashMultiplier + from[i];
+	}
+	return result;
+}
+
+// Length of the region after an exact match where the files mostly
+// match, so it is cheaper to store a bytewise difference than the bytes.
+int approximateMatchLength(
+		const uchar *base,
+		int baseSize,
+		const uchar *data,
+		int size) {
+	const auto limit = std::min(baseSize, size);
+	auto score = 0, best = 0, result = 0;
+	for (auto i = 0; i != limit; ++i) {
+		score += (base[i] == data[i]) ? 1 : -1;
+		if (score > best) {
+			best = score;
+			result = i + 1;
+		} else if (score < best - kDeltaAddTolerance) {
+			break;
+		}
+	}
+	return result;
+}
+
+QByteArray makePatch(const QByteArray &base, const QByteArray &data) {
+	const auto b = reinterpret_cast<const uchar*>(base.constData());
+	const auto d = reinterpret_cast<const uchar*>(data.constData());
+	const auto baseSize = int(base.size());
+	const auto size = int(data.size());
+
+	auto blocks = std::unordered_map<quint32, quint32>();
+	blocks.reserve(baseSize / kDeltaBlockSize + 1);
+	for (auto offset = 0; offset + kDeltaBlockSize <= baseSize; offset += kDeltaBlockSize) {
+		blocks.emplace(blockHash(b + offset), quint32(offset));
+	}
+	const auto outFactor = [] {
+		auto result = quint32(1);
+		for (auto i = 1; i != kDeltaBlockSize; ++i) {
+			result *= kDeltaHashMultiplier;
+		}
+		return result;
+	}();
+
+	auto ops = QByteArray();
+	auto count = quint32(0);
+	{
+		QBuffer buffer(&ops);
+		buffer.open(QIODevice::WriteOnly);
+		QDataStream stream(&buffer);
+		stream.setVersion(QDataStream::Qt_5_1);
+
+		auto pending = QByteArray();
+		const auto flush = [&] {
+			if (!pending.isEmpty()) {
+				stream << quint8(PatchOp::Insert) << pending;
+				pending.clear();
+				++count;
+			}
+		};
+		auto pos = 0;
+		auto hashed = -1;
+		auto hash = quint32(0);
+		while (pos + kDeltaBlockSize <= size) {
+			if (hashed != pos) {
+				hash = blockHash(d + pos);
+				hashed = pos;
+			}
+			const auto i = blocks.find(hash);
+			if (i != blocks.end()
+				&& !memcmp(b + i->second, d + pos, kDeltaBlockSize)) {
+				auto from = int(i->second);
+				auto length = kDeltaBlockSize;
+				while (pos + length < size
+					&& from + length < baseSize
+					&& d[pos + length] == b[from + length]) {
+					++length;
+				}
+				flush();
+				stream << quint8(PatchOp::Copy) << quint32(from) << quint32(length);
+				++count;
+				pos += length;
+				from += length;
+
+				const auto added = approximateMatchLength(
+					b + from,
+					baseSize - from,
+					d + pos,
+					size - pos);
+				if (added >= kDeltaMinAddSize) {
+					auto diff = QByteArray(added, Qt::Uninitialized);
+					for (auto j = 0; j != added; ++j) {
+						diff[j] = char(uchar(d[pos + j] - b[from + j]));
+					}
+					stream << quint8(PatchOp::Add) << quint32(from) << diff;
+					++count;
+					pos += added;
+				}
+				continue;
+			}
+			pending.append(char(d[pos]));
+			if (pos + kDeltaBlockSize < size) {
+				hash = (hash - d[pos] * outFactor) * kDeltaHashMultiplier
+					+ d[pos + kDeltaBlockSize];
+				hashed = pos + 1;
+			}
+			++pos;
+		}
+		pending.append(data.constData() + pos, size - pos);
+		flush();
+	}
+
+	auto result = QByteArray();
+	{
+		QDataStream stream(&result, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream << count;
+	}
+	result.append(ops);
+	return result;
+}
+
+// duplicated in core/update_checker.cpp
+std::optional<QByteArray> applyPatch(
+		const QByteArray &base,
+		const QByteArray &patch,
+		quint32 resultSize) {
+	auto result = QByteArray();
+	result.reserve(resultSize);
+
+	QDataStream stream(patch);
+	stream.setVersion(QDataStream::Qt_5_1);
+
+	quint32 count = 0;
+	stream >> count;
+	const auto inBase = [&](quint32 offset, quint32 length) {
+		return (quint64(offset) + length <= quint64(base.size()));
+	};
+	for (auto i = quint32(0); i != count; ++i) {
+		quint8 op = 0;
+		stream >> op;
+		switch (PatchOp(op)) {
+		case PatchOp::Copy: {
+			quint32 offset = 0, length = 0;
+			stream >> offset >> length;
+			if (!inBase(offset, length)) {
+				return std::nullopt;
+			}
+			result.append(base.constData() + offset, length);
+		} break;
+		case PatchOp::Insert: {
+			QByteArray bytes;
+			stream >> bytes;
+			result.append(bytes);
+		} break;
+		case PatchOp::Add: {
+			quint32 offset = 0;
+			QByteArray diff;
+			stream >> offset >> diff;
+			if (!inBase(offset, diff.size())) {
+				return std::nullopt;
+			}
+			const auto from = base.constData() + offset;
+			const auto till = result.size();
+			result.append(diff);
+			const auto to = result.data() + till;
+			for (auto j = 0, size = int(diff.size()); j != size; ++j) {
+				to[j] = char(uchar(to[j]) + uchar(from[j]));
+			}
+		} break;
+		default: return std::nullopt;
+		}
+		if (stream.status() != QDataStream::Ok
+			|| quint32(result.size()) > resultSize) {
+			return std::nullopt;
+		}
+	}
+	if (stream.status() != QDataStream::Ok
+		|| quint32(result.size()) != resultSize) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+// Writes the file whole or as a patch over the same file of the
+// version the delta is from, whatever is smaller.
+void writeDeltaFile(QDataStream &stream, const QString &name, const QByteArray &data) {
+	QFile f(DeltaBaseDir + name);
+	if (f.open(QIODevice::ReadOnly)) {
+		const auto base = f.readAll();
+		f.close();
+		const auto patch = makePatch(base, data);
+		if (patch.size() < data.size()) {
+			cout << "Patched: " << name.toUtf8().constData() << " (" << patch.size() << ")\n";
+			stream << quint8(1) << countSha1(base) << countSha1(data) << quint32(data.size()) << patch;
+			return;
+		}
+	}
+	stream << quint8(0) << quint32(data.size()) << data;
+}
+
+// Reads the delta package back the way the client does and checks
+// that applying it to the base files gives exactly the packed files.
+bool checkDeltaPackage(const QByteArray &package, const QFileInfoList &files, const QString &remove) {
+	QDataStream stream(package);
+	stream.setVersion(QDataStream::Qt_5_1);
+
+	quint32 tag = 0, version = 0, filesCount = 0;
+	quint64 alphaVersion = 0, baseVersion = 0;
+	stream >> tag >> version;
+	if (version == 0x7FFFFFFF) {
+		stream >> alphaVersion;
+	}
+	stream >> baseVersion >> filesCount;
+	if (stream.status() != QDataStream::Ok
+		|| tag != kDeltaPackageTag
+		|| baseVersion != DeltaBaseVersion
+		|| filesCount != quint32(files.size())) {
+		cout << "Bad delta package header!\n";
+		return false;
+	}
+	for (QFileInfoList::const_iterator i = files.cbegin(); i != files.cend(); ++i) {
+		QString fullName = i->canonicalFilePath();
+		QString expectedName = fullName.mid(remove.length());
+
+		QString name;
+		quint8 patched = 0;
+		QByteArray result;
+		stream >> name >> patched;
+		if (!patched) {
+			quint32 size = 0;
+			stream >> size >> result;
+			if (size != quint32(result.size())) {
+				cout << "Bad delta file size: " << name.toUtf8().constData() << "\n";
+				return false;
+			}
+		} else {
+			QByteArray baseHash, resultHash, patch;
+			quint32 resultSize = 0;
+			stream >> baseHash >> resultHash >> resultSize >> patch;
+
+			QFile b(DeltaBaseDir + name);
+			if (!b.open(QIODevice::ReadOnly)) {
+				cout << "Can't open base '" << b.fileName().toUtf8().constData() << "' for read..\n";
+				return false;
+			}
+			const auto base = b.readAll();
+			b.close();
+			auto applied = (countSha1(base) == baseHash)
+				? applyPatch(base, patch, resultSize)
+				: std::nullopt;
+			if (!applied || countSha1(*applied) != resultHash) {
+				cout << "Bad patch: " << name.toUtf8().constData() << "\n";
+				return false;
+			}
+			result = std::move(*applied);
+		}
+#ifdef Q_OS_UNIX
+		bool executable = false;
+		stream >> executable;
+#endif
+		QFile f(fullName);
+		if (!f.open(QIODevice::ReadOnly)) {
+			cout << "Can't open '" << fullName.toUtf8().constData() << "' for read..\n";
+			return false;
+		}
+		if (stream.status() != QDataStream::Ok
+			|| name != expectedName
+			|| result != f.readAll()) {
+			cout << "Delta result differs: " << expectedName.toUtf8().constData() << "\n";
+			return false;
+		}
+	}
+	if (!stream.atEnd()) {
+		cout << "Delta package has extra data!\n";
+		return false;
+	}
+	return true;
+}
+
+} // namespace
+
 QString AlphaSignature;
 
 int writeAlphaKey() {
@@ -179,6 +489,15 @@ int main(int argc, char *argv[])
 			}
 		} else if (string("-version") == argv[i] && i + 1 < argc) {
 			version = QString(argv[i + 1]).toInt();
+		} else if (string("-base") == argv[i] && i + 1 < argc) {
+			DeltaBaseDir = QDir(workDir + QString(argv[i + 1])).canonicalPath();
+			if (DeltaBaseDir.isEmpty()) {
+				cout << "Bad -base param value passed: " << argv[i + 1] << "\n";
+				return -1;
+			}
+			DeltaBaseDir += "/";
+		} else if (string("-basever") == argv[i] && i + 1 < argc) {
+			DeltaBaseVersion = QString(argv[i + 1]).toULongLong();
 		} else if (string("-beta") == argv[i]) {
 			BetaChannel = true;
 		} else if (string("-alphakey") == argv[i]) {
@@ -211,8 +530,14 @@ int main(int argc, char *argv[])
 #else
 		cout << "Usage: Packer -path {file} -version {version} OR Packer -path {dir} -version {version}\n";
 #endif
+		cout << "Add -base {dir} -basever {version} to pack a delta from the files of that version.\n";
 		return -1;
 	}
+	if (DeltaBaseDir.isEmpty() != !DeltaBaseVersion) {
+		cout << "Both -base and -basever should be passed for a delta package.\n";
+		return -1;
+	}
+	const auto delta = !DeltaBaseDir.isEmpty();
 
 	bool hasDirs = true;
 	while (hasDirs) {
@@ -253,12 +578,18 @@ int main(int argc, char *argv[])
 		QDataStream stream(&buffer);
 		stream.setVersion(QDataStream::Qt_5_1);
 
+		if (delta) {
+			stream << kDeltaPackageTag;
+		}
 		if (AlphaVersion) {
 			stream << quint32(0x7FFFFFFF);
 			stream << quint64(AlphaVersion);
 		} else {
 			stream << quint32(version);
 		}
+		if (delta) {
+			stream << quint64(DeltaBaseVersion);
+		}
 
 		stream << quint32(files.size());
 		cout << "Found " << files.size() << " file" << (files.size() == 1 ? "" : "s") << "..\n";
@@ -274,7 +605,12 @@ int main(int argc, char *argv[])
 				return -1;
 			}
 			QByteArray inner = f.readAll();
-			stream << name << quint32(inner.size()) << inner;
+			stream << name;
+			if (delta) {
+				writeDeltaFile(stream, name, inner);
+			} else {
+				stream << quint32(inner.size()) << inner;
+			}
 #ifdef Q_OS_UNIX
 			stream << (QFileInfo(fullName).isExecutable() ? true : false);
 #endif
@@ -284,6 +620,12 @@ int main(int argc, char *argv[])
 			return -1;
 		}
 	}
+	if (delta) {
+		cout << "Checking delta..\n";
+		if (!checkDeltaPackage(result, files, remove)) {
+			return -1;
+		}
+	}
 
 	int32 resultSize = result.size();
 	cout << "Compression start, size: " << resultSize << "\n";
@@ -509,6 +851,9 @@ int main(int argc, char *argv[])
 #else
 #error Unknown platform!
 #endif
+	if (delta) {
+		outName += QString("_from%1").arg(DeltaBaseVersion);
+	}
 	/*
 	if (AlphaVersion) {
 		outName += "_" + AlphaSignature;
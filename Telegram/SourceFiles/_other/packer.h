@@ -36,6 +36,8 @@ extern "C" {
 #include <string>
 #include <iostream>
 #include <exception>
+#include <optional>
+#include <unordered_map>
 
 using std::string;
 using std::wstring;
@@ -22,10 +22,22 @@ namespace {
 constexpr auto kPreloadIfLess = 5;
 constexpr auto kFirstRequestLimit = 10;
 constexpr auto kNextRequestLimit = 100;
+constexpr auto kPrefetchDelay = crl::time(300);
+constexpr auto kPrefetchUnpinnedLimit = 20;
+
+[[nodiscard]] bool IsPinned(not_null<History*> history) {
+	return history->isPinnedDialog(FilterId());
+}
+
+[[nodiscard]] uint64 SortKey(not_null<History*> history) {
+	return history->sortKeyInChatList(FilterId());
+}
 
 } // namespace
 
-UnreadThings::UnreadThings(not_null<ApiWrap*> api) : _api(api) {
+UnreadThings::UnreadThings(not_null<ApiWrap*> api)
+: _api(api)
+, _prefetchTimer([=] { prefetchNext(); }) {
 }
 
 bool UnreadThings::trackMentions(PeerData *peer) const {
@@ -48,6 +60,90 @@ void UnreadThings::preloadEnough(History *history) {
 	}
 }
 
+void UnreadThings::prefetch(not_null<History*> history) {
+	if (_prefetchQueue.contains(history)
+		|| !canPrefetch(history)
+		|| !needPrefetch(history)) {
+		return;
+	}
+	if (!IsPinned(history)
+		&& _unpinnedPrefetched + unpinnedQueued() >= kPrefetchUnpinnedLimit) {
+		// Keep only the chats that are higher in the list.
+		const auto lowest = ranges::min_element(
+			_prefetchQueue,
+			ranges::less(),
+			[](not_null<History*> queued) {
+				return IsPinned(queued)
+					? std::numeric_limits<uint64>::max()
+					: SortKey(queued);
+			});
+		if (lowest == end(_prefetchQueue)
+			|| IsPinned(*lowest)
+			|| SortKey(*lowest) >= SortKey(history)) {
+			return;
+		}
+		_prefetchQueue.erase(lowest);
+	}
+	_prefetchQueue.emplace(history);
+	if (!_prefetchTimer.isActive()) {
+		_prefetchTimer.callOnce(kPrefetchDelay);
+	}
+}
+
+bool UnreadThings::canPrefetch(not_null<History*> history) const {
+	return history->inChatList()
+		&& !history->folder()
+		&& !history->mute();
+}
+
+int UnreadThings::unpinnedQueued() const {
+	return ranges::count_if(_prefetchQueue, [](not_null<History*> history) {
+		return !IsPinned(history);
+	});
+}
+
+bool UnreadThings::needPrefetch(not_null<History*> history) const {
+	const auto empty = [](const auto &list) {
+		return (list.count() > 0) && !list.loadedCount();
+	};
+	return (trackMentions(history->peer)
+			&& empty(history->unreadMentions())
+			&& !_mentionsRequests.contains(history))
+		|| (trackReactions(history->peer)
+			&& empty(history->unreadReactions())
+			&& !_reactionsRequests.contains(history));
+}
+
+void UnreadThings::prefetchNext() {
+	// Don't compete with the requests for the chat that is open.
+	if (!_mentionsRequests.empty() || !_reactionsRequests.empty()) {
+		_prefetchTimer.callOnce(kPrefetchDelay);
+		return;
+	}
+	while (!_prefetchQueue.empty()) {
+		const auto i = ranges::max_element(
+			_prefetchQueue,
+			ranges::less(),
+			[](not_null<History*> history) {
+				return IsPinned(history)
+					? std::numeric_limits<uint64>::max()
+					: SortKey(history);
+			});
+		const auto history = *i;
+		_prefetchQueue.erase(i);
+		if (canPrefetch(history) && needPrefetch(history)) {
+			if (!IsPinned(history)) {
+				++_unpinnedPrefetched;
+			}
+			preloadEnough(history);
+			break;
+		}
+	}
+	if (!_prefetchQueue.empty()) {
+		_prefetchTimer.callOnce(kPrefetchDelay);
+	}
+}
+
 void UnreadThings::mediaAndMentionsRead(
 		const base::flat_set<MsgId> &readIds,
 		ChannelData *channel) {
@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/timer.h"
+
 class History;
 class ApiWrap;
 class PeerData;
@@ -23,6 +25,12 @@ public:
 
 	void preloadEnough(History *history);
 
+	// Loads the first unread mentions and reactions in the background,
+	// so that the jump buttons work right after the chat is opened.
+	// Only for the pinned chats and the first unread chats of the main
+	// list, archived and muted chats are skipped.
+	void prefetch(not_null<History*> history);
+
 	void mediaAndMentionsRead(
 		const base::flat_set<MsgId> &readIds,
 		ChannelData *channel = nullptr);
@@ -34,8 +42,17 @@ private:
 	void requestMentions(not_null<History*> history, int loaded);
 	void requestReactions(not_null<History*> history, int loaded);
 
+	[[nodiscard]] bool needPrefetch(not_null<History*> history) const;
+	[[nodiscard]] bool canPrefetch(not_null<History*> history) const;
+	[[nodiscard]] int unpinnedQueued() const;
+	void prefetchNext();
+
 	const not_null<ApiWrap*> _api;
 
+	base::flat_set<not_null<History*>> _prefetchQueue;
+	base::Timer _prefetchTimer;
+	int _unpinnedPrefetched = 0;
+
 	base::flat_map<not_null<History*>, mtpRequestId> _mentionsRequests;
 	base::flat_map<not_null<History*>, mtpRequestId> _reactionsRequests;
 
@@ -107,6 +107,8 @@ constexpr auto kNotifySettingSaveTimeout = crl::time(1000);
 constexpr auto kDialogsFirstLoad = 20;
 constexpr auto kDialogsPerPage = 500;
 constexpr auto kJoinErrorDuration = 5 * crl::time(1000);
+constexpr auto kFileReferenceBatchDelay = crl::time(50);
+constexpr auto kFileReferenceBatchLimit = 100;
 
 using PhotoFileLocationId = Data::PhotoFileLocationId;
 using DocumentFileLocationId = Data::DocumentFileLocationId;
@@ -129,6 +131,7 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 , _fileLoader(std::make_unique<TaskQueue>(kFileLoaderQueueStopTimeout))
 , _topPromotionTimer([=] { refreshTopPromotion(); })
 , _updateNotifySettingsTimer([=] { sendNotifySettingsUpdates(); })
+, _fileReferenceBatchTimer([=] { sendFileReferenceBatches(); })
 , _authorizations(std::make_unique<Api::Authorizations>(this))
 , _attachedStickers(std::make_unique<Api::AttachedStickers>(this))
 , _blockedPeers(std::make_unique<Api::BlockedPeers>(this))
@@ -2307,41 +2310,108 @@ void ApiWrap::requestFileReference(
 
 	request(std::move(data)).done([=](const auto &result) {
 		const auto parsed = Data::GetFileReferences(result);
-		for (const auto &p : parsed.data) {
-			// Unpack here the parsed pair by hand to workaround a GCC bug.
-			// See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=87122
-			const auto &origin = p.first;
-			const auto &reference = p.second;
-			const auto documentId = std::get_if<DocumentFileLocationId>(
-				&origin);
-			if (documentId) {
-				_session->data().document(
-					documentId->id
-				)->refreshFileReference(reference);
+		applyFileReferences(parsed);
+		fileReferencesDone(origin, parsed);
+	}).fail([=] {
+		fileReferencesDone(origin, UpdatedFileReferences());
+	}).send();
+}
+
+void ApiWrap::requestMessageFileReference(
+		Data::FileOriginMessage origin,
+		ChannelData *channel,
+		FileReferencesHandler &&handler) {
+	const auto i = _fileReferenceHandlers.find(origin);
+	if (i != end(_fileReferenceHandlers)) {
+		i->second.push_back(std::move(handler));
+		return;
+	}
+	auto handlers = std::vector<FileReferencesHandler>();
+	handlers.push_back(std::move(handler));
+	_fileReferenceHandlers.emplace(origin, std::move(handlers));
+
+	// Many media items usually expire together, after a long sleep,
+	// so we request their messages in batches per channel.
+	_fileReferenceBatches[channel].push_back(origin);
+	if (!_fileReferenceBatchTimer.isActive()) {
+		_fileReferenceBatchTimer.callOnce(kFileReferenceBatchDelay);
+	}
+}
+
+void ApiWrap::sendFileReferenceBatches() {
+	for (auto &[channel, origins] : base::take(_fileReferenceBatches)) {
+		for (auto from = begin(origins); from != end(origins);) {
+			const auto till = from + std::min(
+				int(end(origins) - from),
+				kFileReferenceBatchLimit);
+			const auto batch = std::vector<Data::FileOriginMessage>(
+				from,
+				till);
+			from = till;
+
+			auto ids = QVector<MTPInputMessage>();
+			ids.reserve(batch.size());
+			for (const auto &origin : batch) {
+				ids.push_back(MTP_inputMessageID(MTP_int(origin.msg)));
 			}
-			const auto photoId = std::get_if<PhotoFileLocationId>(&origin);
-			if (photoId) {
-				_session->data().photo(
-					photoId->id
-				)->refreshFileReference(reference);
+			const auto done = [=](const MTPmessages_Messages &result) {
+				const auto parsed = Data::GetFileReferences(result);
+				applyFileReferences(parsed);
+				for (const auto &origin : batch) {
+					fileReferencesDone(origin, parsed);
+				}
+			};
+			const auto fail = [=] {
+				for (const auto &origin : batch) {
+					fileReferencesDone(origin, UpdatedFileReferences());
+				}
+			};
+			if (channel) {
+				request(MTPchannels_GetMessages(
+					channel->inputChannel,
+					MTP_vector<MTPInputMessage>(ids)
+				)).done(done).fail(fail).send();
+			} else {
+				request(MTPmessages_GetMessages(
+					MTP_vector<MTPInputMessage>(ids)
+				)).done(done).fail(fail).send();
 			}
 		}
-		const auto i = _fileReferenceHandlers.find(origin);
-		Assert(i != end(_fileReferenceHandlers));
-		auto handlers = std::move(i->second);
-		_fileReferenceHandlers.erase(i);
-		for (auto &handler : handlers) {
-			handler(parsed);
+	}
+}
+
+void ApiWrap::applyFileReferences(const UpdatedFileReferences &data) {
+	for (const auto &p : data.data) {
+		// Unpack here the parsed pair by hand to workaround a GCC bug.
+		// See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=87122
+		const auto &origin = p.first;
+		const auto &reference = p.second;
+		const auto documentId = std::get_if<DocumentFileLocationId>(
+			&origin);
+		if (documentId) {
+			_session->data().document(
+				documentId->id
+			)->refreshFileReference(reference);
 		}
-	}).fail([=] {
-		const auto i = _fileReferenceHandlers.find(origin);
-		Assert(i != end(_fileReferenceHandlers));
-		auto handlers = std::move(i->second);
-		_fileReferenceHandlers.erase(i);
-		for (auto &handler : handlers) {
-			handler(UpdatedFileReferences());
+		const auto photoId = std::get_if<PhotoFileLocationId>(&origin);
+		if (photoId) {
+			_session->data().photo(
+				photoId->id
+			)->refreshFileReference(reference);
 		}
-	}).send();
+	}
+}
+
+void ApiWrap::fileReferencesDone(
+		Data::FileOrigin origin,
+		const UpdatedFileReferences &data) {
+	const auto i = _fileReferenceHandlers.find(origin);
+	Assert(i != end(_fileReferenceHandlers));
+	auto handlers = std::move(i->second);
+	_fileReferenceHandlers.erase(i);
+	for (auto &handler : handlers) {
+		handler(data);
+	}
 }
 
 void ApiWrap::refreshFileReference(
@@ -2386,17 +2456,11 @@ void ApiWrap::refreshFileReference(
 				request(MTPmessages_GetScheduledMessages(
 					item->history()->peer->input,
 					MTP_vector<MTPint>(1, MTP_int(realId))));
-			} else if (const auto channel = item->history()->peer->asChannel()) {
-				request(MTPchannels_GetMessages(
-					channel->inputChannel,
-					MTP_vector<MTPInputMessage>(
-						1,
-						MTP_inputMessageID(MTP_int(item->id)))));
 			} else {
-				request(MTPmessages_GetMessages(
-					MTP_vector<MTPInputMessage>(
-						1,
-						MTP_inputMessageID(MTP_int(item->id)))));
+				requestMessageFileReference(
+					data,
+					item->history()->peer->asChannel(),
+					std::move(handler));
 			}
 		} else {
 			fail();
@@ -509,6 +509,15 @@ private:
 		Data::FileOrigin origin,
 		FileReferencesHandler &&handler,
 		Request &&data);
+	void requestMessageFileReference(
+		Data::FileOriginMessage origin,
+		ChannelData *channel,
+		FileReferencesHandler &&handler);
+	void sendFileReferenceBatches();
+	void applyFileReferences(const UpdatedFileReferences &data);
+	void fileReferencesDone(
+		Data::FileOrigin origin,
+		const UpdatedFileReferences &data);
 
 	void migrateDone(
 		not_null<PeerData*> peer,
@@ -600,6 +609,10 @@ private:
 	std::map<
 		Data::FileOrigin,
 		std::vector<FileReferencesHandler>> _fileReferenceHandlers;
+	base::flat_map<
+		ChannelData*,
+		std::vector<Data::FileOriginMessage>> _fileReferenceBatches;
+	base::Timer _fileReferenceBatchTimer;
 
 	mtpRequestId _deepLinkInfoRequestId = 0;
 
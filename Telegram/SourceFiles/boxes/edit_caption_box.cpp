@@ -59,10 +59,9 @@ namespace {
 auto ListFromMimeData(not_null<const QMimeData*> data) {
 	using Error = Ui::PreparedList::Error;
 	auto result = data->hasUrls()
-		? Storage::PrepareMediaList(
+		? Storage::PrepareMediaListDeferred(
 			// When we edit media, we need only 1 file.
-			data->urls().mid(0, 1),
-			st::sendMediaPreviewSize)
+			data->urls().mid(0, 1))
 		: Ui::PreparedList(Error::EmptyFile, QString());
 	if (result.error == Error::None) {
 		return result;
@@ -547,6 +546,24 @@ bool EditCaptionBox::setPreparedList(Ui::PreparedList &&list) {
 		return false;
 	}
 	using Error = Ui::PreparedList::Error;
+	const auto id = ++_preparingListId;
+	if (list.error == Error::None
+		&& list.files.empty()
+		&& !list.filesToProcess.empty()) {
+		auto file = std::move(list.filesToProcess.front());
+		const auto weak = Ui::MakeWeak(this);
+		crl::async([weak, id, file = std::move(file)]() mutable {
+			Storage::PrepareDetails(file, st::sendMediaPreviewSize);
+			crl::on_main([weak, id, file = std::move(file)]() mutable {
+				if (weak && weak->_preparingListId == id) {
+					auto list = Ui::PreparedList();
+					list.files.push_back(std::move(file));
+					weak->setPreparedList(std::move(list));
+				}
+			});
+		});
+		return true;
+	}
 	if (list.error != Error::None || list.files.empty()) {
 		return false;
 	}
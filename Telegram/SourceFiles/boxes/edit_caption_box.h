@@ -90,6 +90,7 @@ private:
 	std::shared_ptr<Data::PhotoMedia> _photoMedia;
 
 	Ui::PreparedList _preparedList;
+	uint64 _preparingListId = 0;
 
 	mtpRequestId _saveRequestId = 0;
 
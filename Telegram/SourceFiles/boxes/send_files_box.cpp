@@ -60,6 +60,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace {
 
+constexpr auto kMaxPreparingFiles = 4;
+
 using Ui::SendFilesWay;
 
 inline bool CanAddUrls(const QList<QUrl> &urls) {
@@ -287,30 +289,34 @@ void SendFilesBox::initPreview() {
 }
 
 void SendFilesBox::enqueueNextPrepare() {
-	if (_preparing) {
-		return;
-	}
-	while (!_list.filesToProcess.empty()
-		&& _list.filesToProcess.front().information) {
+	while (true) {
+		while (!_preparing.empty() && _preparing.front()) {
+			addFile(std::move(*_preparing.front()));
+			_preparing.pop_front();
+			++_preparingFirstId;
+		}
+		if (_list.filesToProcess.empty()
+			|| int(_preparing.size()) >= kMaxPreparingFiles) {
+			return;
+		}
 		auto file = std::move(_list.filesToProcess.front());
 		_list.filesToProcess.pop_front();
-		addFile(std::move(file));
-	}
-	if (_list.filesToProcess.empty()) {
-		return;
-	}
-	auto file = std::move(_list.filesToProcess.front());
-	_list.filesToProcess.pop_front();
-	const auto weak = Ui::MakeWeak(this);
-	_preparing = true;
-	crl::async([weak, file = std::move(file)]() mutable {
-		Storage::PrepareDetails(file, st::sendMediaPreviewSize);
-		crl::on_main([weak, file = std::move(file)]() mutable {
-			if (weak) {
-				weak->addPreparedAsyncFile(std::move(file));
-			}
+		if (file.information) {
+			_preparing.emplace_back(std::move(file));
+			continue;
+		}
+		const auto id = _preparingFirstId + _preparing.size();
+		const auto weak = Ui::MakeWeak(this);
+		_preparing.emplace_back();
+		crl::async([weak, id, file = std::move(file)]() mutable {
+			Storage::PrepareDetails(file, st::sendMediaPreviewSize);
+			crl::on_main([weak, id, file = std::move(file)]() mutable {
+				if (weak) {
+					weak->addPreparedAsyncFile(id, std::move(file));
+				}
+			});
 		});
-	});
+	}
 }
 
 void SendFilesBox::setupShadows() {
@@ -790,7 +796,7 @@ bool SendFilesBox::addFiles(not_null<const QMimeData*> data) {
 	auto list = [&] {
 		const auto urls = data->hasUrls() ? data->urls() : QList<QUrl>();
 		auto result = CanAddUrls(urls)
-			? Storage::PrepareMediaList(urls, st::sendMediaPreviewSize)
+			? Storage::PrepareMediaListDeferred(urls)
 			: Ui::PreparedList(
 				Ui::PreparedList::Error::EmptyFile,
 				QString());
@@ -830,17 +836,20 @@ bool SendFilesBox::addFiles(Ui::PreparedList list) {
 	return true;
 }
 
-void SendFilesBox::addPreparedAsyncFile(Ui::PreparedFile &&file) {
+void SendFilesBox::addPreparedAsyncFile(
+		uint64 id,
+		Ui::PreparedFile &&file) {
 	Expects(file.information != nullptr);
+	Expects(id >= _preparingFirstId);
+	Expects(id - _preparingFirstId < _preparing.size());
 
-	_preparing = false;
 	const auto count = int(_list.files.size());
-	addFile(std::move(file));
+	_preparing[id - _preparingFirstId] = std::move(file);
 	enqueueNextPrepare();
 	if (_list.files.size() > count) {
 		refreshAllAfterChanges(count);
 	}
-	if (!_preparing && _whenReadySend) {
+	if (_preparing.empty() && _whenReadySend) {
 		_whenReadySend();
 	}
 }
@@ -995,7 +1004,7 @@ void SendFilesBox::send(
 		&& !options.scheduled) {
 		return sendScheduled();
 	}
-	if (_preparing) {
+	if (!_preparing.empty()) {
 		_whenReadySend = [=] {
 			send(options, ctrlShiftEnter);
 		};
@@ -155,7 +155,7 @@ private:
 	void refreshAllAfterChanges(int fromItem);
 
 	void enqueueNextPrepare();
-	void addPreparedAsyncFile(Ui::PreparedFile &&file);
+	void addPreparedAsyncFile(uint64 id, Ui::PreparedFile &&file);
 
 	const not_null<Window::SessionController*> _controller;
 	const Api::SendType _sendType = Api::SendType();
@@ -195,7 +195,10 @@ private:
 	QPointer<Ui::VerticalLayout> _inner;
 	std::vector<Block> _blocks;
 	Fn<void()> _whenReadySend;
-	bool _preparing = false;
+
+	// Files being prepared in parallel, added to _list in this order.
+	std::deque<std::optional<Ui::PreparedFile>> _preparing;
+	uint64 _preparingFirstId = 0;
 
 	QPointer<Ui::RoundButton> _send;
 	QPointer<Ui::RoundButton> _addFile;
@@ -108,6 +108,7 @@ private:
 		Lottie::Animation *lottie = nullptr;
 		Media::Clip::ReaderPointer webm;
 		Ui::Animations::Simple overAnimation;
+		QImage firstFrame;
 	};
 
 	void visibleTopBottomUpdated(int visibleTop, int visibleBottom) override;
@@ -122,6 +123,7 @@ private:
 		crl::time now) const;
 	void setupLottie(int index);
 	void setupWebm(int index);
+	void firstFrameLoaded(not_null<DocumentData*> document, QImage frame);
 	void clipCallback(
 		Media::Clip::Notification notification,
 		not_null<DocumentData*> document,
@@ -166,6 +168,7 @@ private:
 	crl::time _lastScrolledAt = 0;
 	crl::time _lastUpdatedAt = 0;
 	base::Timer _updateItemsTimer;
+	ChatHelpers::StickerFirstFrames _firstFrames;
 
 	StickerSetIdentifier _input;
 
@@ -475,6 +478,17 @@ StickerSetBox::Inner::Inner(
 	st::windowBgOver,
 	[=] { repaintItems(); }))
 , _updateItemsTimer([=] { updateItems(); })
+, _firstFrames(
+	ChatHelpers::StickerLottieSize::StickerSet,
+	[=](not_null<DocumentData*> document, QImage frame) {
+		firstFrameLoaded(document, std::move(frame));
+	},
+	[=](crl::time delay) {
+		if (!_updateItemsTimer.isActive()
+			|| _updateItemsTimer.remainingTime() > delay) {
+			_updateItemsTimer.callOnce(delay);
+		}
+	})
 , _input(set)
 , _previewTimer([=] { showPreview(); }) {
 	setAttribute(Qt::WA_OpaquePaintEvent);
@@ -968,6 +982,17 @@ void StickerSetBox::Inner::setupWebm(int index) {
 		std::move(callback));
 }
 
+void StickerSetBox::Inner::firstFrameLoaded(
+		not_null<DocumentData*> document,
+		QImage frame) {
+	const auto i = ranges::find(_elements, document, &Element::document);
+	if (i == end(_elements)) {
+		return;
+	}
+	i->firstFrame = std::move(frame);
+	updateItems();
+}
+
 void StickerSetBox::Inner::clipCallback(
 		Media::Clip::Notification notification,
 		not_null<DocumentData*> document,
@@ -1019,7 +1044,14 @@ void StickerSetBox::Inner::paintSticker(
 	const auto sticker = document->sticker();
 	media->checkStickerSmall();
 
-	if (media->loaded()) {
+	auto &firstFrames = const_cast<Inner*>(this)->_firstFrames;
+	if (sticker->isLottie() || sticker->isWebm()) {
+		firstFrames.request(document, boundingBoxSize());
+	}
+	const auto postpone = !element.lottie
+		&& !element.webm
+		&& firstFrames.postponePlayer(document, _lastScrolledAt, now);
+	if (media->loaded() && !postpone) {
 		if (sticker->isLottie() && !element.lottie) {
 			const_cast<Inner*>(this)->setupLottie(index);
 		} else if (sticker->isWebm() && !element.webm) {
@@ -1039,13 +1071,24 @@ void StickerSetBox::Inner::paintSticker(
 		p.drawImage(
 			QRect(ppos, frame.size() / cIntRetinaFactor()),
 			frame);
+		if (firstFrames.needsSave(document)) {
+			firstFrames.save(document, frame);
+		}
 
 		_lottiePlayer->unpause(element.lottie);
 	} else if (element.webm && element.webm->started()) {
-		p.drawPixmap(ppos, element.webm->current({
+		const auto frame = element.webm->current({
 			.frame = size,
 			.keepAlpha = true,
-		}, paused ? 0 : now));
+		}, paused ? 0 : now);
+		p.drawPixmap(ppos, frame);
+		if (firstFrames.needsSave(document)) {
+			firstFrames.save(document, frame.toImage());
+		}
+	} else if (!element.firstFrame.isNull()) {
+		p.drawImage(
+			QRect(ppos, element.firstFrame.size() / cIntRetinaFactor()),
+			element.firstFrame);
 	} else if (const auto image = media->getStickerSmall()) {
 		p.drawPixmapLeft(
 			ppos,
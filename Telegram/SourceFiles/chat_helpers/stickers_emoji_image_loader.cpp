@@ -8,35 +8,149 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "chat_helpers/stickers_emoji_image_loader.h"
 
 #include "kotato/kotato_settings.h"
+#include "base/crc32hash.h"
+#include "core/version.h"
 #include "styles/style_chat.h"
 
+#include <QtCore/QDir>
+
 namespace Stickers {
+namespace {
+
+constexpr auto kMaxCacheSize = int64(16 * 1024 * 1024);
+constexpr auto kTrimmedCacheSize = kMaxCacheSize / 2;
+
+[[nodiscard]] QString CacheFolder() {
+	return cWorkingDir() + u"tdata/emoji_large/"_q;
+}
+
+// Images of a cloud set may be updated under the same set id,
+// so the cache is keyed by a checksum of the set files as well.
+[[nodiscard]] QString SetVersion(int id) {
+	if (!id) {
+		// The built-in set comes with the app.
+		return QString::number(AppVersion);
+	}
+	auto data = QByteArray();
+	const auto folder = Ui::Emoji::internal::SetDataPath(id);
+	const auto list = QDir(folder).entryInfoList(QDir::Files, QDir::Name);
+	for (const auto &info : list) {
+		data += info.fileName().toUtf8()
+			+ ':' + QByteArray::number(info.size())
+			+ ':' + QByteArray::number(
+				info.lastModified().toMSecsSinceEpoch())
+			+ ';';
+	}
+	return QString::number(base::crc32(data.constData(), data.size()), 16);
+}
+
+[[nodiscard]] int64 FolderSize(const QString &folder) {
+	auto result = int64();
+	for (const auto &info : QDir(folder).entryInfoList(QDir::Files)) {
+		result += info.size();
+	}
+	return result;
+}
+
+} // namespace
 
 EmojiImageLoader::EmojiImageLoader(crl::weak_on_queue<EmojiImageLoader> weak)
 : _weak(std::move(weak)) {
 }
 
-void EmojiImageLoader::init(
-		std::shared_ptr<UniversalImages> images,
-		bool largeEnabled) {
+void EmojiImageLoader::init(std::shared_ptr<UniversalImages> images) {
 	Expects(images != nullptr);
 
+	// Source images are loaded only when some image is not in the cache.
 	_images = std::move(images);
-	if (largeEnabled) {
-		_images->ensureLoaded();
+	refreshCacheFolder();
+}
+
+void EmojiImageLoader::refreshCacheFolder() {
+	const auto name = u"%1_%2"_q
+		.arg(_images->id())
+		.arg(SetVersion(_images->id()));
+	const auto folder = CacheFolder() + name + '/';
+	if (_cacheFolder == folder) {
+		return;
+	}
+	_cacheFolder = folder;
+
+	// Only the images of the current set and its version are kept.
+	const auto root = QDir(CacheFolder());
+	const auto entries = root.entryList(
+		QDir::AllEntries | QDir::NoDotAndDotDot);
+	for (const auto &entry : entries) {
+		if (entry != name) {
+			const auto path = root.filePath(entry);
+			if (QFileInfo(path).isDir()) {
+				QDir(path).removeRecursively();
+			} else {
+				QFile::remove(path);
+			}
+		}
 	}
+	_cacheSize = FolderSize(_cacheFolder);
+}
+
+void EmojiImageLoader::saveToCache(
+		const QImage &image,
+		const QString &path) const {
+	QDir().mkpath(_cacheFolder);
+	if (!image.save(path, "PNG")) {
+		return;
+	}
+	_cacheSize += QFileInfo(path).size();
+	if (_cacheSize <= kMaxCacheSize) {
+		return;
+	}
+	// Drop the images that were written first.
+	const auto list = QDir(_cacheFolder).entryInfoList(
+		QDir::Files,
+		QDir::Time | QDir::Reversed);
+	for (const auto &info : list) {
+		if (_cacheSize <= kTrimmedCacheSize) {
+			break;
+		} else if (QFile::remove(info.filePath())) {
+			_cacheSize -= info.size();
+		}
+	}
+}
+
+QString EmojiImageLoader::cachePath(EmojiPtr emoji, bool outline) const {
+	const auto factor = cIntRetinaFactor();
+	const auto side = st::largeEmojiSize + 2 * st::largeEmojiOutline;
+	return _cacheFolder + u"%1_%2%3.png"_q
+		.arg(emoji->index())
+		.arg(side * factor)
+		.arg(outline ? u"_o"_q : QString());
 }
 
 QImage EmojiImageLoader::prepare(EmojiPtr emoji) const {
+	const auto outline = ::Kotato::JsonSettings::GetBool(
+		"big_emoji_outline");
+	const auto path = cachePath(emoji, outline);
+	const auto side = (st::largeEmojiSize + 2 * st::largeEmojiOutline)
+		* cIntRetinaFactor();
+	auto cached = QImage(path);
+	if (cached.width() == side && cached.height() == side) {
+		return cached.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+	}
+	auto result = render(emoji, outline);
+	if (_images->ensureLoaded()) {
+		saveToCache(result, path);
+	}
+	return result;
+}
+
+QImage EmojiImageLoader::render(EmojiPtr emoji, bool outline) const {
 	const auto loaded = _images->ensureLoaded();
 	const auto factor = cIntRetinaFactor();
 	const auto side = st::largeEmojiSize + 2 * st::largeEmojiOutline;
 	auto tinted = QImage(
 		QSize(st::largeEmojiSize, st::largeEmojiSize) * factor,
 		QImage::Format_ARGB32_Premultiplied);
-	tinted.fill(::Kotato::JsonSettings::GetBool("big_emoji_outline")
-		? Qt::white
-		: QColor(0, 0, 0, 0));
+	tinted.fill(outline ? Qt::white : QColor(0, 0, 0, 0));
 	if (loaded) {
 		QPainter p(&tinted);
 		p.setCompositionMode(QPainter::CompositionMode_DestinationIn);
@@ -89,6 +203,7 @@ QImage EmojiImageLoader::prepare(EmojiPtr emoji) const {
 
 void EmojiImageLoader::switchTo(std::shared_ptr<UniversalImages> images) {
 	_images = std::move(images);
+	refreshCacheFolder();
 }
 
 auto EmojiImageLoader::releaseImages() -> std::shared_ptr<UniversalImages> {
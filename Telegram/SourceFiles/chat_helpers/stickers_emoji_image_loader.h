@@ -17,17 +17,22 @@ public:
 
 	explicit EmojiImageLoader(crl::weak_on_queue<EmojiImageLoader> weak);
 
-	void init(
-		std::shared_ptr<UniversalImages> images,
-		bool largeEnabled);
+	void init(std::shared_ptr<UniversalImages> images);
 
 	[[nodiscard]] QImage prepare(EmojiPtr emoji) const;
 	void switchTo(std::shared_ptr<UniversalImages> images);
 	std::shared_ptr<UniversalImages> releaseImages();
 
 private:
+	void refreshCacheFolder();
+	void saveToCache(const QImage &image, const QString &path) const;
+	[[nodiscard]] QString cachePath(EmojiPtr emoji, bool outline) const;
+	[[nodiscard]] QImage render(EmojiPtr emoji, bool outline) const;
+
 	crl::weak_on_queue<EmojiImageLoader> _weak;
 	std::shared_ptr<UniversalImages> _images;
+	QString _cacheFolder;
+	mutable int64 _cacheSize = 0;
 
 };
 
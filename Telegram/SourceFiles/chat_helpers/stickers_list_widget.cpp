@@ -1046,6 +1046,17 @@ StickersListWidget::StickersListWidget(
 , _isMasks(masks)
 , _updateItemsTimer([=] { updateItems(); })
 , _updateSetsTimer([=] { updateSets(); })
+, _firstFrames(
+	StickerLottieSize::StickersPanel,
+	[=](not_null<DocumentData*> document, QImage frame) {
+		firstFrameLoaded(document, std::move(frame));
+	},
+	[=](crl::time delay) {
+		if (!_updateItemsTimer.isActive()
+			|| _updateItemsTimer.remainingTime() > delay) {
+			_updateItemsTimer.callOnce(delay);
+		}
+	})
 , _pathGradient(std::make_unique<Ui::PathShiftGradient>(
 	st::windowBgRipple,
 	st::windowBgOver,
@@ -1906,6 +1917,7 @@ void StickersListWidget::clearHeavyIn(Set &set, bool clearSavedFrames) {
 	for (auto &sticker : set.stickers) {
 		if (clearSavedFrames) {
 			sticker.savedFrame = QPixmap();
+			_firstFrames.forget(sticker.document);
 		}
 		sticker.webm = nullptr;
 		sticker.lottie = nullptr;
@@ -2050,6 +2062,26 @@ void StickersListWidget::setupWebm(Set &set, int section, int index) {
 		std::move(callback));
 }
 
+void StickersListWidget::firstFrameLoaded(
+		not_null<DocumentData*> document,
+		QImage frame) {
+	if (!frame.isNull()) {
+		auto pixmap = QPixmap::fromImage(std::move(frame), Qt::ColorOnly);
+		pixmap.setDevicePixelRatio(cRetinaFactor());
+		for (const auto list : { &_mySets, &_officialSets, &_searchSets }) {
+			for (auto &set : *list) {
+				for (auto &sticker : set.stickers) {
+					if (sticker.document == document
+						&& sticker.savedFrame.isNull()) {
+						sticker.savedFrame = pixmap;
+					}
+				}
+			}
+		}
+	}
+	updateItems();
+}
+
 void StickersListWidget::clipCallback(
 		Media::Clip::Notification notification,
 		uint64 setId,
@@ -2201,12 +2233,19 @@ void StickersListWidget::paintSticker(
 
 	const auto isLottie = document->sticker()->isLottie();
 	const auto isWebm = document->sticker()->isWebm();
-	if (isLottie
+	if (isLottie || isWebm) {
+		_firstFrames.request(document, boundingBoxSize());
+	}
+	const auto postpone = (isLottie || isWebm)
 		&& !sticker.lottie
-		&& media->loaded()) {
-		setupLottie(set, section, index);
-	} else if (isWebm && !sticker.webm && media->loaded()) {
-		setupWebm(set, section, index);
+		&& !sticker.webm
+		&& _firstFrames.postponePlayer(document, _lastScrolledAt, now);
+	if (!postpone && media->loaded()) {
+		if (isLottie && !sticker.lottie) {
+			setupLottie(set, section, index);
+		} else if (isWebm && !sticker.webm) {
+			setupWebm(set, section, index);
+		}
 	}
 
 	int row = (index / _columnCount), col = (index % _columnCount);
@@ -2236,6 +2275,9 @@ void StickersListWidget::paintSticker(
 			sticker.savedFrame = QPixmap::fromImage(frame, Qt::ColorOnly);
 			sticker.savedFrame.setDevicePixelRatio(cRetinaFactor());
 		}
+		if (_firstFrames.needsSave(document)) {
+			_firstFrames.save(document, frame);
+		}
 		set.lottiePlayer->unpause(sticker.lottie);
 	} else if (sticker.webm && sticker.webm->started()) {
 		const auto frame = sticker.webm->current(
@@ -2245,6 +2287,9 @@ void StickersListWidget::paintSticker(
 			sticker.savedFrame = frame;
 			sticker.savedFrame.setDevicePixelRatio(cRetinaFactor());
 		}
+		if (_firstFrames.needsSave(document)) {
+			_firstFrames.save(document, frame.toImage());
+		}
 		p.drawPixmapLeft(ppos, width(), frame);
 	} else {
 		const auto image = media->getStickerSmall();
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "chat_helpers/tabbed_selector.h"
+#include "chat_helpers/stickers_lottie.h"
 #include "data/stickers/data_stickers.h"
 #include "media/clip/media_clip_reader.h"
 #include "base/variant.h"
@@ -296,6 +297,7 @@ private:
 	void ensureLottiePlayer(Set &set);
 	void setupLottie(Set &set, int section, int index);
 	void setupWebm(Set &set, int section, int index);
+	void firstFrameLoaded(not_null<DocumentData*> document, QImage frame);
 	void clipCallback(
 		Media::Clip::Notification notification,
 		uint64 setId,
@@ -385,6 +387,7 @@ private:
 
 	base::Timer _updateItemsTimer;
 	base::Timer _updateSetsTimer;
+	StickerFirstFrames _firstFrames;
 	base::flat_set<uint64> _repaintSetsIds;
 
 	bool _displayingSet = false;
@@ -21,10 +21,30 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/effects/path_shift_gradient.h"
 #include "main/main_session.h"
 
+#include <QtCore/QBuffer>
+
 namespace ChatHelpers {
 namespace {
 
 constexpr auto kDontCacheLottieAfterArea = 512 * 512;
+constexpr auto kLazyPlayerDelay = crl::time(300);
+
+// Streaming slices use the lower shifts, while stickers are small
+// enough for them to never reach this shift.
+constexpr auto kFirstFrameKeyShift = 0x8000;
+
+[[nodiscard]] Storage::Cache::Key FirstFrameCacheKey(
+		not_null<DocumentData*> document,
+		StickerLottieSize sizeTag) {
+	const auto baseKey = document->bigFileBaseCacheKey();
+	if (!baseKey) {
+		return {};
+	}
+	return Storage::Cache::Key{
+		baseKey.high,
+		baseKey.low + kFirstFrameKeyShift + uint8(sizeTag)
+	};
+}
 
 } // namespace
 
@@ -232,6 +252,122 @@ Media::Clip::ReaderPointer WebmThumbnail(
 			std::move(callback));
 }
 
+void LoadStickerFirstFrame(
+		not_null<DocumentData*> document,
+		StickerLottieSize sizeTag,
+		QSize size,
+		Fn<void(QImage)> done) {
+	const auto key = FirstFrameCacheKey(document, sizeTag);
+	if (!key) {
+		done(QImage());
+		return;
+	}
+	const auto weak = base::make_weak(&document->session());
+	document->owner().cacheBigFile().get(key, [=](QByteArray &&cached) {
+		auto image = cached.isEmpty()
+			? QImage()
+			: QImage::fromData(cached, "PNG");
+		if (!image.isNull() && image.size() != size) {
+			image = image.scaled(
+				size,
+				Qt::KeepAspectRatio,
+				Qt::SmoothTransformation);
+		}
+		crl::on_main(weak, [=, image = std::move(image)]() mutable {
+			done(std::move(image));
+		});
+	});
+}
+
+void SaveStickerFirstFrame(
+		not_null<DocumentData*> document,
+		StickerLottieSize sizeTag,
+		QImage frame) {
+	const auto key = FirstFrameCacheKey(document, sizeTag);
+	if (!key || frame.isNull()) {
+		return;
+	}
+	const auto weak = base::make_weak(&document->session());
+	crl::async([=, frame = std::move(frame)] {
+		auto bytes = QByteArray();
+		{
+			QBuffer buffer(&bytes);
+			frame.save(&buffer, "PNG");
+		}
+		crl::on_main(weak, [=, bytes = std::move(bytes)]() mutable {
+			weak->data().cacheBigFile().put(key, std::move(bytes));
+		});
+	});
+}
+
+StickerFirstFrames::StickerFirstFrames(
+	StickerLottieSize sizeTag,
+	Fn<void(not_null<DocumentData*>, QImage)> loaded,
+	Fn<void(crl::time)> repaintIn)
+: _sizeTag(sizeTag)
+, _loaded(std::move(loaded))
+, _repaintIn(std::move(repaintIn)) {
+}
+
+void StickerFirstFrames::request(
+		not_null<DocumentData*> document,
+		QSize box) {
+	if (!_states.emplace(document, State::Loading).second) {
+		return;
+	}
+	const auto size = ComputeStickerSize(document, box)
+		* style::DevicePixelRatio();
+	LoadStickerFirstFrame(
+		document,
+		_sizeTag,
+		size,
+		crl::guard(this, [=](QImage frame) {
+			const auto i = _states.find(document);
+			if (i == end(_states) || i->second != State::Loading) {
+				return;
+			}
+			i->second = frame.isNull() ? State::Missing : State::Cached;
+			_loaded(document, std::move(frame));
+		}));
+}
+
+bool StickerFirstFrames::needsSave(not_null<DocumentData*> document) const {
+	const auto i = _states.find(document);
+	return (i != end(_states)) && (i->second == State::Missing);
+}
+
+void StickerFirstFrames::save(
+		not_null<DocumentData*> document,
+		QImage frame) {
+	if (!needsSave(document)) {
+		return;
+	}
+	_states[document] = State::Saved;
+	SaveStickerFirstFrame(document, _sizeTag, std::move(frame));
+}
+
+void StickerFirstFrames::forget(not_null<DocumentData*> document) {
+	_states.remove(document);
+}
+
+bool StickerFirstFrames::postponePlayer(
+		not_null<DocumentData*> document,
+		crl::time lastScrolledAt,
+		crl::time now) const {
+	const auto i = _states.find(document);
+	if (i == end(_states) || i->second == State::Missing) {
+		return false;
+	} else if (i->second == State::Loading) {
+		return true;
+	}
+	const auto delay = lastScrolledAt + kLazyPlayerDelay - now;
+	if (delay <= 0) {
+		return false;
+	}
+	_repaintIn(delay);
+	return true;
+}
+
 bool PaintStickerThumbnailPath(
 		QPainter &p,
 		not_null<Data::DocumentMedia*> media,
@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/weak_ptr.h"
+
 namespace base {
 template <typename Enum>
 class Flags;
@@ -101,6 +103,54 @@ enum class StickerLottieSize : uchar {
 	Data::DocumentMedia *media,
 	Fn<void(Media::Clip::Notification)> callback);
 
+// First frames of animated stickers are kept in the big file cache,
+// so that they are shown before the animation is loaded and parsed.
+void LoadStickerFirstFrame(
+	not_null<DocumentData*> document,
+	StickerLottieSize sizeTag,
+	QSize size,
+	Fn<void(QImage)> done);
+void SaveStickerFirstFrame(
+	not_null<DocumentData*> document,
+	StickerLottieSize sizeTag,
+	QImage frame);
+
+// Tracks the cached first frames of the stickers of one widget. The
+// cached frame is shown while scrolling and the player is created only
+// when the sticker stays visible for a while.
+class StickerFirstFrames final : public base::has_weak_ptr {
+public:
+	StickerFirstFrames(
+		StickerLottieSize sizeTag,
+		Fn<void(not_null<DocumentData*>, QImage)> loaded,
+		Fn<void(crl::time)> repaintIn);
+
+	// Loads the cached frame once, loaded() gets a null image if none.
+	void request(not_null<DocumentData*> document, QSize box);
+	[[nodiscard]] bool needsSave(not_null<DocumentData*> document) const;
+	void save(not_null<DocumentData*> document, QImage frame);
+	void forget(not_null<DocumentData*> document);
+
+	[[nodiscard]] bool postponePlayer(
+		not_null<DocumentData*> document,
+		crl::time lastScrolledAt,
+		crl::time now) const;
+
+private:
+	enum class State : uchar {
+		Loading,
+		Cached,
+		Missing,
+		Saved,
+	};
+
+	const StickerLottieSize _sizeTag;
+	const Fn<void(not_null<DocumentData*>, QImage)> _loaded;
+	const Fn<void(crl::time)> _repaintIn;
+	base::flat_map<not_null<DocumentData*>, State> _states;
+
+};
+
 bool PaintStickerThumbnailPath(
 	QPainter &p,
 	not_null<Data::DocumentMedia*> media,
@@ -571,10 +571,9 @@ void Application::startLocalStorage() {
 
 void Application::startEmojiImageLoader() {
 	_emojiImageLoader.with([
-		source = prepareEmojiSourceImages(),
-		large = settings().largeEmoji()
+		source = prepareEmojiSourceImages()
 	](Stickers::EmojiImageLoader &loader) mutable {
-		loader.init(std::move(source), large);
+		loader.init(std::move(source));
 	});
 
 	settings().largeEmojiChanges(
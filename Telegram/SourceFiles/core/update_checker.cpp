@@ -57,6 +57,10 @@ namespace {
 constexpr auto kUpdaterTimeout = 10 * crl::time(1000);
 constexpr auto kMaxResponseSize = 1024 * 1024;
 
+// Delta packages start with this tag instead of the version, it is
+// negative as int32, so clients without delta support reject them.
+constexpr auto kDeltaPackageTag = quint32(0x8DE17A00);
+
 #ifdef TDESKTOP_DISABLE_AUTOUPDATE
 bool UpdaterIsDisabled = true;
 #else // TDESKTOP_DISABLE_AUTOUPDATE
@@ -65,6 +69,10 @@ bool UpdaterIsDisabled = false;
 
 std::weak_ptr<Updater> UpdaterInstance;
 
+// Set when a delta package could not be applied to the installed files,
+// the full package is requested on the next check.
+std::atomic<bool> SkipDeltaUpdates = false;
+
 using Progress = UpdateChecker::Progress;
 using State = UpdateChecker::State;
 
@@ -265,6 +273,139 @@ QString ExtractFilename(const QString &url) {
 	return QString();
 }
 
+#ifndef TDESKTOP_DISABLE_AUTOUPDATE
+enum class PatchOp : quint8 {
+	Copy, // base[offset, offset + length)
+	Insert, // bytes
+	Add, // base[offset, offset + diff.size()) + diff, bytewise
+};
+
+// duplicated in _other/packer.cpp
+[[nodiscard]] std::optional<QByteArray> ApplyPatch(
+		const QByteArray &base,
+		const QByteArray &patch,
+		quint32 resultSize) {
+	auto result = QByteArray();
+	result.reserve(resultSize);
+
+	QDataStream stream(patch);
+	stream.setVersion(QDataStream::Qt_5_1);
+
+	quint32 count = 0;
+	stream >> count;
+	const auto inBase = [&](quint32 offset, quint32 length) {
+		return (quint64(offset) + length <= quint64(base.size()));
+	};
+	for (auto i = quint32(0); i != count; ++i) {
+		quint8 op = 0;
+		stream >> op;
+		switch (PatchOp(op)) {
+		case PatchOp::Copy: {
+			quint32 offset = 0, length = 0;
+			stream >> offset >> length;
+			if (!inBase(offset, length)) {
+				return std::nullopt;
+			}
+			result.append(base.constData() + offset, length);
+		} break;
+		case PatchOp::Insert: {
+			QByteArray bytes;
+			stream >> bytes;
+			result.append(bytes);
+		} break;
+		case PatchOp::Add: {
+			quint32 offset = 0;
+			QByteArray diff;
+			stream >> offset >> diff;
+			if (!inBase(offset, diff.size())) {
+				return std::nullopt;
+			}
+			const auto from = base.constData() + offset;
+			const auto till = result.size();
+			result.append(diff);
+			const auto to = result.data() + till;
+			for (auto j = 0, size = int(diff.size()); j != size; ++j) {
+				to[j] = char(uchar(to[j]) + uchar(from[j]));
+			}
+		} break;
+		default: return std::nullopt;
+		}
+		if (stream.status() != QDataStream::Ok
+			|| quint32(result.size()) > resultSize) {
+			return std::nullopt;
+		}
+	}
+	if (stream.status() != QDataStream::Ok
+		|| quint32(result.size()) != resultSize) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+[[nodiscard]] QString InstalledFilePath(const QString &relativeName) {
+#ifdef Q_OS_MAC
+	return cExeDir() + qsl("../../../") + relativeName;
+#else // Q_OS_MAC
+	return cExeDir() + relativeName;
+#endif // Q_OS_MAC
+}
+
+[[nodiscard]] bool SameSha1(const QByteArray &data, const QByteArray &hash) {
+	const auto computed = hashSha1(data.constData(), data.size());
+	return (hash.size() == computed.size())
+		&& !memcmp(hash.constData(), computed.data(), computed.size());
+}
+
+// Reads a file entry of a delta package: either the whole file,
+// or a patch over the installed file of the version the delta is from.
+[[nodiscard]] std::optional<QByteArray> ReadDeltaFile(
+		QDataStream &stream,
+		const QString &relativeName) {
+	quint8 patched = 0;
+	stream >> patched;
+	if (!patched) {
+		quint32 fileSize = 0;
+		QByteArray fileInnerData;
+		stream >> fileSize >> fileInnerData;
+		if (stream.status() != QDataStream::Ok
+			|| fileSize != quint32(fileInnerData.size())) {
+			LOG(("Update Error: bad delta file entry '%1'"
+				).arg(relativeName));
+			return std::nullopt;
+		}
+		return fileInnerData;
+	}
+	QByteArray baseHash, resultHash, patch;
+	quint32 resultSize = 0;
+	stream >> baseHash >> resultHash >> resultSize >> patch;
+	if (stream.status() != QDataStream::Ok) {
+		LOG(("Update Error: cant read patch for '%1', status: %2"
+			).arg(relativeName
+			).arg(stream.status()));
+		return std::nullopt;
+	}
+	QFile installed(InstalledFilePath(relativeName));
+	if (!installed.open(QIODevice::ReadOnly)) {
+		LOG(("Update Error: cant read installed file '%1' to patch"
+			).arg(installed.fileName()));
+		return std::nullopt;
+	}
+	const auto base = installed.readAll();
+	installed.close();
+	if (!SameSha1(base, baseHash)) {
+		LOG(("Update Error: installed file '%1' doesn't match the delta"
+			).arg(relativeName));
+		return std::nullopt;
+	}
+	auto result = ApplyPatch(base, patch, resultSize);
+	if (!result || !SameSha1(*result, resultHash)) {
+		LOG(("Update Error: bad patch result for '%1'").arg(relativeName));
+		return std::nullopt;
+	}
+	return result;
+}
+#endif // !TDESKTOP_DISABLE_AUTOUPDATE
+
 bool UnpackUpdate(const QString &filepath) {
 #ifndef TDESKTOP_DISABLE_AUTOUPDATE
 	QFile input(filepath);
@@ -408,6 +549,10 @@ bool UnpackUpdate(const QString &filepath) {
 		stream.setVersion(QDataStream::Qt_5_1);
 
 		stream >> version;
+		const auto delta = (version == kDeltaPackageTag);
+		if (delta) {
+			stream >> version;
+		}
 		if (stream.status() != QDataStream::Ok) {
 			LOG(("Update Error: cant read version from downloaded stream, status: %1").arg(stream.status()));
 			return false;
@@ -428,6 +573,19 @@ bool UnpackUpdate(const QString &filepath) {
 			LOG(("Update Error: downloaded version %1 is not greater, than mine %2").arg(version).arg(AppKotatoVersion));
 			return false;
 		}
+		if (delta) {
+			quint64 baseVersion = 0;
+			stream >> baseVersion;
+			const auto myVersion = cAlphaVersion()
+				? cAlphaVersion()
+				: quint64(AppKotatoVersion);
+			if (stream.status() != QDataStream::Ok
+				|| baseVersion != myVersion) {
+				LOG(("Update Error: delta is from version %1, mine is %2").arg(baseVersion).arg(myVersion));
+				SkipDeltaUpdates = true;
+				return false;
+			}
+		}
 
 		quint32 filesCount;
 		stream >> filesCount;
@@ -445,7 +603,18 @@ bool UnpackUpdate(const QString &filepath) {
 			QByteArray fileInnerData;
 			bool executable = false;
 
-			stream >> relativeName >> fileSize >> fileInnerData;
+			stream >> relativeName;
+			if (delta) {
+				auto data = ReadDeltaFile(stream, relativeName);
+				if (!data) {
+					SkipDeltaUpdates = true;
+					return false;
+				}
+				fileInnerData = std::move(*data);
+				fileSize = quint32(fileInnerData.size());
+			} else {
+				stream >> fileSize >> fileInnerData;
+			}
 #ifdef Q_OS_UNIX
 			stream >> executable;
 #endif // Q_OS_UNIX
@@ -754,6 +923,17 @@ std::optional<QString> HttpChecker::parseResponse(
 			return false;
 		}
 		bestLink = (*link).toString();
+
+		// "deltas": { "<installed version>": "<link>" } for the versions
+		// that have a delta package to this one.
+		const auto deltas = map.value("deltas").toObject();
+		const auto mine = deltas.constFind(QString::number(AppKotatoVersion));
+		if (!isAlpha
+			&& !SkipDeltaUpdates
+			&& mine != deltas.constEnd()
+			&& (*mine).isString()) {
+			bestLink = (*mine).toString();
+		}
 		return true;
 	};
 	const auto result = ParseCommonMap(response, testing(), accumulate);
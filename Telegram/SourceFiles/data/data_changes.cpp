@@ -23,7 +23,7 @@ void Changes::Manager<DataType, UpdateType>::updated(
 			flags |= i->second;
 			_updates.erase(i);
 		}
-		_stream.fire({ data, flags });
+		fire(data, flags);
 	} else {
 		_updates[data] |= flags;
 	}
@@ -41,6 +41,42 @@ void Changes::Manager<DataType, UpdateType>::sendRealtimeNotifications(
 	}
 }
 
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::fire(
+		not_null<DataType*> data,
+		Flags flags) {
+	const auto i = _subscribers->find(data);
+	if (i != _subscribers->end() && (i->second.mask & flags)) {
+		i->second.stream.fire({ data, flags });
+	}
+	_stream.fire({ data, flags });
+}
+
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::Unsubscribe(
+		Registry &registry,
+		not_null<DataType*> data,
+		Flags flags) {
+	const auto i = registry.find(data);
+	if (i == registry.end()) {
+		return;
+	}
+	auto &masks = i->second.masks;
+	const auto j = ranges::find(masks, flags);
+	if (j != masks.end()) {
+		masks.erase(j);
+	}
+	if (masks.empty()) {
+		registry.erase(i);
+		return;
+	}
+	auto mask = Flags();
+	for (const auto subscriber : masks) {
+		mask |= subscriber;
+	}
+	i->second.mask = mask;
+}
+
 template <typename DataType, typename UpdateType>
 rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::updates(
 		Flags flags) const {
@@ -54,11 +90,29 @@ template <typename DataType, typename UpdateType>
 rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::updates(
 		not_null<DataType*> data,
 		Flags flags) const {
-	return _stream.events(
-	) | rpl::filter([=](const UpdateType &update) {
-		const auto [updateData, updateFlags] = update;
-		return (updateData == data) && (updateFlags & flags);
-	});
+	const auto weak = std::weak_ptr<Registry>(_subscribers);
+	return [=](auto consumer) {
+		auto result = rpl::lifetime();
+		const auto registry = weak.lock();
+		if (!registry) {
+			return result;
+		}
+		auto &subscribers = (*registry)[data];
+		subscribers.masks.push_back(flags);
+		subscribers.mask |= flags;
+		subscribers.stream.events(
+		) | rpl::filter([=](const UpdateType &update) {
+			return (update.flags & flags);
+		}) | rpl::start_with_next([=](const UpdateType &update) {
+			consumer.put_next_copy(update);
+		}, result);
+		result.add([=] {
+			if (const auto registry = weak.lock()) {
+				Unsubscribe(*registry, data, flags);
+			}
+		});
+		return result;
+	};
 }
 
 template <typename DataType, typename UpdateType>
@@ -79,7 +133,7 @@ rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::flagsValue(
 template <typename DataType, typename UpdateType>
 void Changes::Manager<DataType, UpdateType>::sendNotifications() {
 	for (const auto &[data, flags] : base::take(_updates)) {
-		_stream.fire({ data, flags });
+		fire(data, flags);
 	}
 }
 
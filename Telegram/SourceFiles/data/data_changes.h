@@ -274,14 +274,32 @@ private:
 	private:
 		static constexpr auto kCount = details::CountBit<Flag>() + 1;
 
+		struct Subscribers {
+			rpl::event_stream<UpdateType> stream;
+			std::vector<Flags> masks;
+			Flags mask = 0;
+		};
+		using Registry = base::flat_map<not_null<DataType*>, Subscribers>;
+
+		static void Unsubscribe(
+			Registry &registry,
+			not_null<DataType*> data,
+			Flags flags);
+
 		void sendRealtimeNotifications(
 			not_null<DataType*> data,
 			Flags flags);
+		void fire(not_null<DataType*> data, Flags flags);
 
 		std::array<rpl::event_stream<UpdateType>, kCount> _realtimeStreams;
 		base::flat_map<not_null<DataType*>, Flags> _updates;
 		rpl::event_stream<UpdateType> _stream;
 
+		// Per-object subscribers, so that an update is delivered only to
+		// the subscribers of the updated object with intersecting flags.
+		const std::shared_ptr<Registry> _subscribers
+			= std::make_shared<Registry>();
+
 	};
 
 	void scheduleNotifications();
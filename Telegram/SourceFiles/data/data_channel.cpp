@@ -99,6 +99,30 @@ void ChannelData::setPhoto(const MTPChatPhoto &photo) {
 	});
 }
 
+void ChannelData::setFlags(ChannelDataFlags which) {
+	const auto megagroup = isMegagroup();
+	_flags.set(which);
+	if (megagroup != isMegagroup()) {
+		owner().peersTable().refreshFlags(this);
+	}
+}
+
+void ChannelData::addFlags(ChannelDataFlags which) {
+	const auto megagroup = isMegagroup();
+	_flags.add(which);
+	if (megagroup != isMegagroup()) {
+		owner().peersTable().refreshFlags(this);
+	}
+}
+
+void ChannelData::removeFlags(ChannelDataFlags which) {
+	const auto megagroup = isMegagroup();
+	_flags.remove(which);
+	if (megagroup != isMegagroup()) {
+		owner().peersTable().refreshFlags(this);
+	}
+}
+
 void ChannelData::setName(const QString &newName, const QString &newUsername) {
 	updateNameDelayed(newName.isEmpty() ? name : newName, QString(), newUsername);
 }
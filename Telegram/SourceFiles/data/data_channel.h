@@ -140,15 +140,9 @@ public:
 	void setPhoto(const MTPChatPhoto &photo);
 	void setAccessHash(uint64 accessHash);
 
-	void setFlags(ChannelDataFlags which) {
-		_flags.set(which);
-	}
-	void addFlags(ChannelDataFlags which) {
-		_flags.add(which);
-	}
-	void removeFlags(ChannelDataFlags which) {
-		_flags.remove(which);
-	}
+	void setFlags(ChannelDataFlags which);
+	void addFlags(ChannelDataFlags which);
+	void removeFlags(ChannelDataFlags which);
 	[[nodiscard]] auto flags() const {
 		return _flags.current();
 	}
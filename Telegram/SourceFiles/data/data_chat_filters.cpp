@@ -224,6 +224,7 @@ LocalFolder MakeLocalFolder(const QJsonObject &obj) {
 ChatFilter::ChatFilter(FilterId id, bool isLocal)
 : _id(id)
 , _isLocal(isLocal) {
+	compile();
 }
 
 ChatFilter::ChatFilter(
@@ -247,6 +248,7 @@ ChatFilter::ChatFilter(
 , _isDefault(isDefault)
 , _isLocal(isLocal)
 , _cloudLocalOrder(cloudLocalOrder) {
+	compile();
 }
 
 ChatFilter ChatFilter::local(
@@ -471,73 +473,30 @@ const base::flat_set<not_null<History*>> &ChatFilter::never() const {
 }
 
 bool ChatFilter::contains(not_null<History*> history) const {
+	return contains(history, ComputeChatFilterAttributes(history));
+}
+
+bool ChatFilter::contains(
+		not_null<History*> history,
+		ChatFilterAttributes attributes) const {
+	using Attribute = ChatFilterAttribute;
+
 	if (_never.contains(history)) {
 		return false;
+	} else if (_always.contains(history)) {
+		return true;
 	}
-	const auto flag = [&] {
-		const auto peer = history->peer;
-		if (const auto user = peer->asUser()) {
-			return user->isBot()
-				? Flag::Bots
-				: user->isContact()
-				? Flag::Contacts
-				: Flag::NonContacts;
-		} else if (const auto chat = peer->asChat()) {
-			return Flag::Groups;
-		} else if (const auto channel = peer->asChannel()) {
-			if (channel->isBroadcast()) {
-				return Flag::Channels;
-			} else {
-				return Flag::Groups;
-			}
-		} else {
-			Unexpected("Peer type in ChatFilter::contains.");
-		}
-	}();
 	const auto filterAdmin = [&] {
-		if (!(_flags & Flag::Owned)
-			&& !(_flags & Flag::NotOwned)
-			&& !(_flags & Flag::Admin)
-			&& !(_flags & Flag::NotAdmin)) {
+		if (!_rolesFiltered) {
 			return true;
+		} else if (!(attributes & (Attribute::Group | Attribute::Channel))) {
+			return false;
 		}
-
-		const auto peer = history->peer;
-		if (const auto chat = peer->asChat()) {
-			// if i created the chat:
-			// // if the filter excludes owned chats, don't add in list
-			// // if the filter excludes non-admin chats, add only if filter includes owned chats
-			// else if i am admin in chat:
-			// // if the filter excludes admin chats, don't add in list
-			// // if the filter excludes non-owned chats, add only if filter includes admin chats
-			// else:
-			// // add in list only if filter doesn't exclude non-owned or non-admin chats
-			if (chat->amCreator()) {
-				return !(_flags & Flag::NotOwned) && ((_flags & Flag::Admin)
-					? (_flags & Flag::Owned)
-					: true);
-			} else if (chat->hasAdminRights()) {
-				return !(_flags & Flag::NotAdmin) && ((_flags & Flag::Owned)
-					? (_flags & Flag::Admin)
-					: true);
-			} else {
-				return !(_flags & Flag::Owned) && !(_flags & Flag::Admin);
-			}
-		} else if (const auto channel = peer->asChannel()) {
-			if (channel->amCreator()) {
-				return !(_flags & Flag::NotOwned) && ((_flags & Flag::Admin)
-					? (_flags & Flag::Owned)
-					: true);
-			} else if (channel->hasAdminRights()) {
-				return !(_flags & Flag::NotAdmin) && ((_flags & Flag::Owned)
-					? (_flags & Flag::Admin)
-					: true);
-			} else {
-				return !(_flags & Flag::Owned) && !(_flags & Flag::Admin);
-			}
-		}
-
-		return false;
+		return (attributes & Attribute::Owned)
+			? _ownedAllowed
+			: (attributes & Attribute::Admin)
+			? _adminAllowed
+			: _memberAllowed;
 	};
 	const auto filterUnfiltered = [&] {
 		if (!(_flags & Flag::NoFilter)) {
@@ -545,37 +504,137 @@ bool ChatFilter::contains(not_null<History*> history) const {
 		}
 
 		const auto &list = history->owner().chatsFilters().list();
-		for (auto filter : list) {
+		for (const auto &filter : list) {
 			if (filter.id() == _id) {
 				continue;
 			}
 
-			if (filter.contains(history)) {
+			if (filter.contains(history, attributes)) {
 				return false;
 			}
 		}
 
 		return true;
 	};
-	return false
-		|| ((_flags & flag)
-			&& filterAdmin()
-			&& (!(_flags & Flag::Recent)
-				|| history->owner().session().account().isRecent(history->peer->id))
-			&& (!(_flags & Flag::NoMuted)
-				|| !history->mute()
-				|| (history->unreadMentions().has()
-					&& history->folderKnown()
-					&& !history->folder()))
-			&& (!(_flags & Flag::NoRead)
-				|| history->unreadCount()
-				|| history->unreadMark()
-				|| history->unreadMentions().has()
-				|| history->fakeUnreadWhileOpened())
-			&& (!(_flags & Flag::NoArchived)
-				|| (history->folderKnown() && !history->folder()))
-			&& filterUnfiltered())
-		|| _always.contains(history);
+	return (attributes & _accepted)
+		&& !(attributes & _excluded)
+		&& ((attributes & _required) == _required)
+		&& filterAdmin()
+		&& filterUnfiltered();
+}
+
+ChatFilterAttributes ChatFilter::dependencies() const {
+	return _dependencies;
+}
+
+void ChatFilter::compile() {
+	using Attribute = ChatFilterAttribute;
+
+	const auto types = {
+		std::make_pair(Flag::Contacts, Attribute::Contact),
+		std::make_pair(Flag::NonContacts, Attribute::NonContact),
+		std::make_pair(Flag::Groups, Attribute::Group),
+		std::make_pair(Flag::Channels, Attribute::Channel),
+		std::make_pair(Flag::Bots, Attribute::Bot),
+	};
+	_accepted = _excluded = _required = ChatFilterAttributes();
+	_dependencies = ChatFilterAttributes();
+	for (const auto &[flag, attribute] : types) {
+		if (_flags & flag) {
+			_accepted |= attribute;
+		}
+		_dependencies |= attribute;
+	}
+	if (_flags & Flag::NoMuted) {
+		_excluded |= Attribute::Muted;
+	}
+	if (_flags & Flag::NoArchived) {
+		_excluded |= Attribute::Archived;
+	}
+	if (_flags & Flag::NoRead) {
+		_required |= Attribute::Unread;
+	}
+	if (_flags & Flag::Recent) {
+		_required |= Attribute::Recent;
+	}
+	_dependencies |= _excluded | _required;
+
+	// If I created the chat:
+	// - if the filter excludes owned chats, don't add in list,
+	// - if the filter excludes non-admin chats,
+	//   add only if filter includes owned chats.
+	// Else if I am admin in chat:
+	// - if the filter excludes admin chats, don't add in list,
+	// - if the filter excludes non-owned chats,
+	//   add only if filter includes admin chats.
+	// Else add in list only if filter doesn't exclude
+	// non-owned or non-admin chats.
+	const auto owned = !!(_flags & Flag::Owned);
+	const auto admin = !!(_flags & Flag::Admin);
+	const auto notOwned = !!(_flags & Flag::NotOwned);
+	const auto notAdmin = !!(_flags & Flag::NotAdmin);
+	_rolesFiltered = owned || admin || notOwned || notAdmin;
+	_ownedAllowed = !notOwned && (!admin || owned);
+	_adminAllowed = !notAdmin && (!owned || admin);
+	_memberAllowed = !owned && !admin;
+	if (_rolesFiltered) {
+		_dependencies |= Attribute::Owned | Attribute::Admin;
+	}
+
+	// Depends on the membership in all other filters.
+	if (_flags & Flag::NoFilter) {
+		_dependencies = ChatFilterAttributes::from_raw(0xFFFF);
+	}
+}
+
+ChatFilterAttributes ComputeChatFilterAttributes(
+		not_null<History*> history) {
+	using Attribute = ChatFilterAttribute;
+
+	auto result = ChatFilterAttributes();
+	const auto peer = history->peer;
+	const auto role = [&](auto chat) {
+		if (chat->amCreator()) {
+			result |= Attribute::Owned;
+		} else if (chat->hasAdminRights()) {
+			result |= Attribute::Admin;
+		}
+	};
+	if (const auto user = peer->asUser()) {
+		result |= user->isBot()
+			? Attribute::Bot
+			: user->isContact()
+			? Attribute::Contact
+			: Attribute::NonContact;
+	} else if (const auto chat = peer->asChat()) {
+		result |= Attribute::Group;
+		role(chat);
+	} else if (const auto channel = peer->asChannel()) {
+		result |= channel->isBroadcast()
+			? Attribute::Channel
+			: Attribute::Group;
+		role(channel);
+	} else {
+		Unexpected("Peer type in ComputeChatFilterAttributes.");
+	}
+	const auto notArchived = history->folderKnown() && !history->folder();
+	if (!notArchived) {
+		result |= Attribute::Archived;
+	}
+	if (history->mute()
+		&& !(history->unreadMentions().has() && notArchived)) {
+		result |= Attribute::Muted;
+	}
+	if (history->unreadCount()
+		|| history->unreadMark()
+		|| history->unreadMentions().has()
+		|| history->fakeUnreadWhileOpened()) {
+		result |= Attribute::Unread;
+	}
+	if (history->owner().session().account().isRecent(peer->id)) {
+		result |= Attribute::Recent;
+	}
+	return result;
 }
 
 bool ChatFilter::isLocal() const {
@@ -774,10 +833,15 @@ bool ChatFilters::applyChange(ChatFilter &filter, ChatFilter &&updated) {
 		return false;
 	}
 	if (rulesChanged) {
+		// Memberships are recomputed here with the current attributes,
+		// so the remembered ones can't be used for the diffs anymore.
+		_attributes.clear();
+
 		const auto filterList = _owner->chatsFilters().chatsList(id);
 		const auto feedHistory = [&](not_null<History*> history) {
-			const auto now = updated.contains(history);
-			const auto was = filter.contains(history);
+			const auto attributes = ComputeChatFilterAttributes(history);
+			const auto now = updated.contains(history, attributes);
+			const auto was = filter.contains(history, attributes);
 			if (now != was) {
 				if (now) {
 					history->addToChatList(id, filterList);
@@ -993,6 +1057,21 @@ void ChatFilters::refreshHistory(not_null<History*> history) {
 	}
 }
 
+ChatFilterAttributes ChatFilters::updateAttributes(
+		not_null<History*> history,
+		ChatFilterAttributes attributes) {
+	const auto [i, ok] = _attributes.emplace(history.get(), attributes);
+	if (ok) {
+		return ChatFilterAttributes::from_raw(0xFFFF);
+	}
+	const auto was = std::exchange(i->second, attributes);
+	return ChatFilterAttributes::from_raw(was.value() ^ attributes.value());
+}
+
+void ChatFilters::forgetAttributes(not_null<History*> history) {
+	_attributes.erase(history.get());
+}
+
 void ChatFilters::requestSuggested() {
 	if (_suggestedRequestId) {
 		return;
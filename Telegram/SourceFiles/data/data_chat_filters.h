@@ -21,6 +21,26 @@ namespace Data {
 class Session;
 struct LocalFolder;
 
+// Compact snapshot of the history properties the chat filters depend on.
+enum class ChatFilterAttribute : ushort {
+	Contact    = 0x0001,
+	NonContact = 0x0002,
+	Group      = 0x0004,
+	Channel    = 0x0008,
+	Bot        = 0x0010,
+	Muted      = 0x0020, // Muted and not forced by unread mentions.
+	Unread     = 0x0040,
+	Archived   = 0x0080,
+	Owned      = 0x0100,
+	Admin      = 0x0200,
+	Recent     = 0x0400,
+};
+inline constexpr bool is_flag_type(ChatFilterAttribute) { return true; };
+using ChatFilterAttributes = base::flags<ChatFilterAttribute>;
+
+[[nodiscard]] ChatFilterAttributes ComputeChatFilterAttributes(
+	not_null<History*> history);
+
 class ChatFilter final {
 public:
 	enum class Flag : ushort {
@@ -81,6 +101,10 @@ public:
 	[[nodiscard]] const base::flat_set<not_null<History*>> &never() const;
 
 	[[nodiscard]] bool contains(not_null<History*> history) const;
+	[[nodiscard]] bool contains(
+		not_null<History*> history,
+		ChatFilterAttributes attributes) const;
+	[[nodiscard]] ChatFilterAttributes dependencies() const;
 
 	[[nodiscard]] bool isLocal() const;
 
@@ -89,6 +113,8 @@ public:
 	}
 
 private:
+	void compile();
+
 	FilterId _id = 0;
 	QString _title;
 	QString _iconEmoji;
@@ -100,6 +126,15 @@ private:
 	bool _isLocal = false;
 	int _cloudLocalOrder = 0;
 
+	ChatFilterAttributes _accepted;
+	ChatFilterAttributes _excluded;
+	ChatFilterAttributes _required;
+	ChatFilterAttributes _dependencies;
+	bool _rolesFiltered = false;
+	bool _ownedAllowed = false;
+	bool _adminAllowed = false;
+	bool _memberAllowed = false;
+
 };
 
 inline bool operator==(const ChatFilter &a, const ChatFilter &b) {
@@ -137,6 +172,13 @@ public:
 
 	void refreshHistory(not_null<History*> history);
 
+	// Remembers the attributes used to compute the filters membership
+	// and returns the ones that changed since the previous refresh.
+	[[nodiscard]] ChatFilterAttributes updateAttributes(
+		not_null<History*> history,
+		ChatFilterAttributes attributes);
+	void forgetAttributes(not_null<History*> history);
+
 	[[nodiscard]] not_null<Dialogs::MainList*> chatsList(FilterId filterId);
 
 	const ChatFilter &applyUpdatedPinned(
@@ -168,6 +210,7 @@ private:
 
 	std::vector<ChatFilter> _list;
 	base::flat_map<FilterId, std::unique_ptr<Dialogs::MainList>> _chatsLists;
+	std::unordered_map<History*, ChatFilterAttributes> _attributes;
 	rpl::event_stream<> _listChanged;
 	mtpRequestId _loadRequestId = 0;
 	mtpRequestId _saveOrderRequestId = 0;
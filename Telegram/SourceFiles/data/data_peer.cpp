@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_file_origin.h"
 #include "data/data_histories.h"
 #include "data/data_cloud_themes.h"
+#include "data/data_userpic_cache.h"
 #include "base/unixtime.h"
 #include "base/crc32hash.h"
 #include "lang/lang_keys.h"
@@ -52,6 +53,51 @@ constexpr auto kUserpicSize = 160;
 
 using UpdateFlag = Data::PeerUpdate::Flag;
 
+[[nodiscard]] QImage GenerateEmptyUserpic(
+		not_null<Ui::EmptyUserpic*> empty,
+		int size,
+		ImageRoundRadius radius) {
+	auto result = QImage(
+		QSize(size, size),
+		QImage::Format_ARGB32_Premultiplied);
+	result.fill(Qt::transparent);
+	{
+		Painter p(&result);
+		if (radius == ImageRoundRadius::Ellipse) {
+			empty->paint(p, 0, 0, size, size);
+		} else if (radius == ImageRoundRadius::Large) {
+			empty->paintRoundedLarge(p, 0, 0, size, size);
+		} else if (radius == ImageRoundRadius::None) {
+			empty->paintSquare(p, 0, 0, size, size);
+		} else {
+			empty->paintRounded(p, 0, 0, size, size);
+		}
+	}
+	return result;
+}
+
+// Painting the initials is much slower than blitting a ready image,
+// and the same empty userpic is shown in many rows at the same size.
+void PaintEmptyUserpic(
+		Painter &p,
+		not_null<Ui::EmptyUserpic*> empty,
+		int x,
+		int y,
+		int size,
+		ImageRoundRadius radius) {
+	const auto ratio = style::DevicePixelRatio();
+	p.drawImage(x, y, Data::CachedUserpicImage(
+		empty->uniqueKey(),
+		size,
+		ratio,
+		radius,
+		[&] {
+			auto result = GenerateEmptyUserpic(empty, size * ratio, radius);
+			result.setDevicePixelRatio(ratio);
+			return result;
+		}));
+}
+
 } // namespace
 
 namespace Data {
@@ -254,6 +300,9 @@ void PeerData::updateNameDelayed(
 		}
 	}
 	fillNames();
+	if (flags & UpdateFlag::Username) {
+		owner().peersTable().refreshUsername(this);
+	}
 	if (nameUpdated) {
 		session().changes().nameUpdated(this, std::move(oldFirstLetters));
 	}
@@ -350,7 +399,13 @@ void PeerData::paintUserpicCircled(
 			y,
 			userpic->pix(size, size, { .options = circled }));
 	} else {
-		ensureEmptyUserpic()->paint(p, x, y, x + size + x, size);
+		PaintEmptyUserpic(
+			p,
+			ensureEmptyUserpic(),
+			x,
+			y,
+			size,
+			ImageRoundRadius::Ellipse);
 	}
 }
 
@@ -364,7 +419,13 @@ void PeerData::paintUserpicRoundedLarge(
 		const auto rounded = Images::Option::RoundLarge;
 		p.drawPixmap(x, y, userpic->pix(size, size, { .options = rounded }));
 	} else {
-		ensureEmptyUserpic()->paintRoundedLarge(p, x, y, x + size + x, size);
+		PaintEmptyUserpic(
+			p,
+			ensureEmptyUserpic(),
+			x,
+			y,
+			size,
+			ImageRoundRadius::Large);
 	}
 }
 
@@ -378,7 +439,13 @@ void PeerData::paintUserpicRounded(
 		const auto rounded = Images::Option::RoundSmall;
 		p.drawPixmap(x, y, userpic->pix(size, size, { .options = rounded }));
 	} else {
-		ensureEmptyUserpic()->paintRounded(p, x, y, x + size + x, size);
+		PaintEmptyUserpic(
+			p,
+			ensureEmptyUserpic(),
+			x,
+			y,
+			size,
+			ImageRoundRadius::Small);
 	}
 }
 
@@ -391,7 +458,13 @@ void PeerData::paintUserpicSquare(
 	if (const auto userpic = currentUserpic(view)) {
 		p.drawPixmap(x, y, userpic->pix(size, size));
 	} else {
-		ensureEmptyUserpic()->paintSquare(p, x, y, x + size + x, size);
+		PaintEmptyUserpic(
+			p,
+			ensureEmptyUserpic(),
+			x,
+			y,
+			size,
+			ImageRoundRadius::None);
 	}
 }
 
@@ -483,27 +556,24 @@ QImage PeerData::generateUserpicImage(
 			: (radius == ImageRoundRadius::None)
 			? Images::Option()
 			: Images::Option::RoundSmall;
-		return userpic->pixNoCache(
-			{ size, size },
-			{ .options = options }).toImage();
-	}
-	auto result = QImage(
-		QSize(size, size),
-		QImage::Format_ARGB32_Premultiplied);
-	result.fill(Qt::transparent);
-	{
-		Painter p(&result);
-		if (radius == ImageRoundRadius::Ellipse) {
-			ensureEmptyUserpic()->paint(p, 0, 0, size, size);
-		} else if (radius == ImageRoundRadius::Large) {
-			ensureEmptyUserpic()->paintRoundedLarge(p, 0, 0, size, size);
-		} else if (radius == ImageRoundRadius::None) {
-			ensureEmptyUserpic()->paintSquare(p, 0, 0, size, size);
-		} else {
-			ensureEmptyUserpic()->paintRounded(p, 0, 0, size, size);
-		}
+		const auto generate = [&] {
+			return userpic->pixNoCache(
+				{ size, size },
+				{ .options = options }).toImage();
+		};
+		return hasUserpic()
+			? Data::CachedUserpicImage(
+				inMemoryKey(_userpic.location()),
+				size,
+				1,
+				radius,
+				generate)
+			: generate();
 	}
-	return result;
+	const auto empty = ensureEmptyUserpic();
+	return Data::CachedUserpicImage(empty->uniqueKey(), size, 1, radius, [&] {
+		return GenerateEmptyUserpic(empty, size, radius);
+	});
 }
 
 Data::FileOrigin PeerData::userpicOrigin() const {
@@ -0,0 +1,78 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_peers_table.h"
+
+#include "data/data_peer.h"
+#include "data/data_channel.h"
+
+namespace Data {
+namespace {
+
+[[nodiscard]] uint UsernameHash(const QString &username) {
+	return username.isEmpty() ? 0 : qHash(username.toLower());
+}
+
+[[nodiscard]] PeersTable::Flags ComputeFlags(not_null<PeerData*> peer) {
+	using Flag = PeersTable::Flag;
+	auto result = PeersTable::Flags();
+	if (peer->isUser()) {
+		result |= Flag::User;
+	} else if (peer->isChat()) {
+		result |= Flag::Chat;
+	} else if (const auto channel = peer->asChannel()) {
+		result |= channel->isMegagroup() ? Flag::Megagroup : Flag::Broadcast;
+	}
+	return result;
+}
+
+} // namespace
+
+void PeersTable::add(not_null<PeerData*> peer) {
+	const auto [i, ok] = _indices.emplace(peer->id, int(_rows.size()));
+	if (!ok) {
+		return;
+	}
+	_rows.push_back({
+		.peer = peer,
+		.usernameHash = UsernameHash(peer->userName()),
+		.flags = ComputeFlags(peer),
+	});
+}
+
+auto PeersTable::find(not_null<PeerData*> peer) -> Row* {
+	const auto i = _indices.find(peer->id);
+	return (i != end(_indices)) ? &_rows[i->second] : nullptr;
+}
+
+void PeersTable::refreshFlags(not_null<PeerData*> peer) {
+	if (const auto row = find(peer)) {
+		row->flags = ComputeFlags(peer);
+	}
+}
+
+void PeersTable::refreshUsername(not_null<PeerData*> peer) {
+	if (const auto row = find(peer)) {
+		row->usernameHash = UsernameHash(peer->userName());
+	}
+}
+
+PeerData *PeersTable::findByUsername(const QString &username) const {
+	const auto hash = UsernameHash(username);
+	if (!hash) {
+		return nullptr;
+	}
+	for (const auto &row : _rows) {
+		if (row.usernameHash == hash
+			&& !row.peer->userName().compare(username, Qt::CaseInsensitive)) {
+			return row.peer;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace Data
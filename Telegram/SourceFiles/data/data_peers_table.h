@@ -0,0 +1,63 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/flags.h"
+
+class PeerData;
+
+namespace Data {
+
+// Compact copy of the PeerData fields that are scanned over all the
+// known peers, so that those scans don't touch the peer objects.
+// Only the peer kind and the username are kept here: name words are
+// heap strings that a copy wouldn't make cheaper to match, and the
+// chat list and peer list searches go through first letter indices
+// of their own rows instead of scanning all the peers.
+class PeersTable final {
+public:
+	enum class Flag : uchar {
+		User      = 0x01,
+		Chat      = 0x02,
+		Megagroup = 0x04,
+		Broadcast = 0x08,
+	};
+	friend inline constexpr bool is_flag_type(Flag) { return true; };
+	using Flags = base::flags<Flag>;
+
+	void add(not_null<PeerData*> peer);
+	void refreshFlags(not_null<PeerData*> peer);
+	void refreshUsername(not_null<PeerData*> peer);
+
+	[[nodiscard]] PeerData *findByUsername(const QString &username) const;
+
+	// Peers added from the callback are not enumerated.
+	template <typename Callback>
+	void enumerate(Flags types, Callback &&callback) const {
+		for (auto i = 0, count = int(_rows.size()); i != count; ++i) {
+			if (_rows[i].flags & types) {
+				callback(_rows[i].peer);
+			}
+		}
+	}
+
+private:
+	struct Row {
+		not_null<PeerData*> peer;
+		uint usernameHash = 0;
+		Flags flags;
+	};
+
+	[[nodiscard]] Row *find(not_null<PeerData*> peer);
+
+	std::vector<Row> _rows;
+	std::unordered_map<PeerId, int> _indices;
+
+};
+
+} // namespace Data
@@ -115,6 +115,7 @@ void SendActionManager::repliesPaintersClear(
 }
 
 bool SendActionManager::callback(crl::time now) {
+	_collectingUpdates = true;
 	for (auto i = begin(_sendActions); i != end(_sendActions);) {
 		const auto sendAction = lookupPainter(
 			i->first.first,
@@ -125,16 +126,43 @@ bool SendActionManager::callback(crl::time now) {
 			i = _sendActions.erase(i);
 		}
 	}
+	_collectingUpdates = false;
+	flushAnimationUpdates();
 	return !_sendActions.empty();
 }
 
+void SendActionManager::flushAnimationUpdates() {
+	for (auto &[_, update] : base::take(_animationUpdates)) {
+		_animationUpdate.fire(std::move(update));
+	}
+	for (const auto history : base::take(_speakingAnimationUpdates)) {
+		_speakingAnimationUpdate.fire_copy(history);
+	}
+}
+
 auto SendActionManager::animationUpdated() const
 -> rpl::producer<SendActionManager::AnimationUpdate> {
 	return _animationUpdate.events();
 }
 
 void SendActionManager::updateAnimation(AnimationUpdate &&update) {
-	_animationUpdate.fire(std::move(update));
+	if (!_collectingUpdates) {
+		_animationUpdate.fire(std::move(update));
+		return;
+	}
+	const auto i = _animationUpdates.find(update.history);
+	if (i == end(_animationUpdates)) {
+		_animationUpdates.emplace(update.history, std::move(update));
+		return;
+	}
+	auto &merged = i->second;
+	const auto right = std::max(
+		merged.left + merged.width,
+		update.left + update.width);
+	merged.left = std::min(merged.left, update.left);
+	merged.width = right - merged.left;
+	merged.height = std::max(merged.height, update.height);
+	merged.textUpdated = merged.textUpdated || update.textUpdated;
 }
 
 auto SendActionManager::speakingAnimationUpdated() const
@@ -143,11 +171,17 @@ auto SendActionManager::speakingAnimationUpdated() const
 }
 
 void SendActionManager::updateSpeakingAnimation(not_null<History*> history) {
-	_speakingAnimationUpdate.fire_copy(history);
+	if (!_collectingUpdates) {
+		_speakingAnimationUpdate.fire_copy(history);
+		return;
+	}
+	_speakingAnimationUpdates.emplace(history);
 }
 
 void SendActionManager::clear() {
 	_sendActions.clear();
+	_animationUpdates.clear();
+	_speakingAnimationUpdates.clear();
 }
 
 } // namespace Data
@@ -57,6 +57,7 @@ public:
 
 private:
 	bool callback(crl::time now);
+	void flushAnimationUpdates();
 	[[nodiscard]] SendActionPainter *lookupPainter(
 		not_null<History*> history,
 		MsgId rootId);
@@ -67,6 +68,12 @@ private:
 		crl::time> _sendActions;
 	Ui::Animations::Basic _animation;
 
+	// Updates from all painters are merged while the animation ticks,
+	// so that every history is repainted at most once per frame.
+	base::flat_map<not_null<History*>, AnimationUpdate> _animationUpdates;
+	base::flat_set<not_null<History*>> _speakingAnimationUpdates;
+	bool _collectingUpdates = false;
+
 	rpl::event_stream<AnimationUpdate> _animationUpdate;
 	rpl::event_stream<not_null<History*>> _speakingAnimationUpdate;
 
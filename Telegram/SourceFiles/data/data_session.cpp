@@ -329,7 +329,9 @@ not_null<PeerData*> Session::peer(PeerId id) {
 	}();
 
 	result->input = MTPinputPeer(MTP_inputPeerEmpty());
-	return _peers.emplace(id, std::move(result)).first->second.get();
+	const auto raw = _peers.emplace(id, std::move(result)).first->second.get();
+	_peersTable.add(raw);
+	return raw;
 }
 
 not_null<UserData*> Session::user(UserId id) {
@@ -915,40 +917,30 @@ void Session::unregisterInvitedToCallUser(
 }
 
 PeerData *Session::peerByUsername(const QString &username) const {
-	const auto uname = username.trimmed();
-	for (const auto &[peerId, peer] : _peers) {
-		if (!peer->userName().compare(uname, Qt::CaseInsensitive)) {
-			return peer.get();
-		}
-	}
-	return nullptr;
+	return _peersTable.findByUsername(username.trimmed());
 }
 
 void Session::enumerateUsers(Fn<void(not_null<UserData*>)> action) const {
-	for (const auto &[peerId, peer] : _peers) {
-		if (const auto user = peer->asUser()) {
-			action(user);
-		}
-	}
+	_peersTable.enumerate(PeersTable::Flag::User, [&](not_null<PeerData*> peer) {
+		action(peer->asUser());
+	});
 }
 
 void Session::enumerateGroups(Fn<void(not_null<PeerData*>)> action) const {
-	for (const auto &[peerId, peer] : _peers) {
-		if (peer->isChat() || peer->isMegagroup()) {
-			action(peer.get());
-		}
-	}
+	_peersTable.enumerate(
+		PeersTable::Flag::Chat | PeersTable::Flag::Megagroup,
+		action);
 }
 
 void Session::enumerateChannels(
 		Fn<void(not_null<ChannelData*>)> action) const {
-	for (const auto &[peerId, peer] : _peers) {
-		if (const auto channel = peer->asChannel()) {
-			if (!channel->isMegagroup()) {
-				action(channel);
-			}
-		}
-	}
+	_peersTable.enumerate(PeersTable::Flag::Broadcast, [&](not_null<PeerData*> peer) {
+		action(peer->asChannel());
+	});
+}
+
+PeersTable &Session::peersTable() {
+	return _peersTable;
 }
 
 not_null<History*> Session::history(PeerId peerId) {
@@ -3676,7 +3668,11 @@ rpl::producer<not_null<ChannelData*>> Session::channelDifferenceTooLong() const
 }
 
 void Session::registerItemView(not_null<ViewElement*> view) {
-	_views[view->data()].push_back(view);
+	auto &list = _views[view->data()];
+	if (list.empty()) {
+		view->data()->expandText();
+	}
+	list.push_back(view);
 }
 
 void Session::unregisterItemView(not_null<ViewElement*> view) {
@@ -3688,6 +3684,7 @@ void Session::unregisterItemView(not_null<ViewElement*> view) {
 		list.erase(ranges::remove(list, view), end(list));
 		if (list.empty()) {
 			_views.erase(i);
+			view->data()->compactText();
 		}
 	}
 
@@ -3773,11 +3770,23 @@ void Session::refreshChatListEntry(Dialogs::Key key) {
 	if (!history) {
 		return;
 	}
-	for (const auto &filter : _chatsFilters->list()) {
+	const auto &filters = _chatsFilters->list();
+	const auto attributes = filters.empty()
+		? ChatFilterAttributes()
+		: ComputeChatFilterAttributes(history);
+	const auto changed = filters.empty()
+		? ChatFilterAttributes()
+		: _chatsFilters->updateAttributes(history, attributes);
+	for (const auto &filter : filters) {
 		const auto id = filter.id();
 		const auto filterList = chatsFilters().chatsList(id);
 		auto event = ChatListEntryRefresh{ .key = key, .filterId = id };
-		if (filter.contains(history)) {
+
+		// Re-evaluate only the filters affected by the changed attributes.
+		const auto contains = (filter.dependencies() & changed)
+			? filter.contains(history, attributes)
+			: entry->inChatList(id);
+		if (contains) {
 			event.existenceChanged = !entry->inChatList(id);
 			if (event.existenceChanged) {
 				entry->addToChatList(id, filterList);
@@ -3810,6 +3819,9 @@ void Session::removeChatListEntry(Dialogs::Key key) {
 		return;
 	}
 	Assert(entry->folderKnown());
+	if (const auto history = key.history()) {
+		_chatsFilters->forgetAttributes(history);
+	}
 	for (const auto &filter : _chatsFilters->list()) {
 		const auto id = filter.id();
 		if (entry->inChatList(id)) {
@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "dialogs/dialogs_indexed_list.h"
 #include "dialogs/dialogs_main_list.h"
 #include "data/data_groups.h"
+#include "data/data_peers_table.h"
 #include "data/data_cloud_file.h"
 #include "data/data_notify_settings.h"
 #include "history/history_location_manager.h"
@@ -191,6 +192,7 @@ public:
 	void enumerateGroups(Fn<void(not_null<PeerData*>)> action) const;
 	void enumerateChannels(Fn<void(not_null<ChannelData*>)> action) const;
 	[[nodiscard]] PeerData *peerByUsername(const QString &username) const;
+	[[nodiscard]] PeersTable &peersTable();
 
 	[[nodiscard]] not_null<History*> history(PeerId peerId);
 	[[nodiscard]] History *historyLoaded(PeerId peerId) const;
@@ -962,6 +964,7 @@ private:
 	base::Timer _unmuteByFinishedTimer;
 
 	std::unordered_map<PeerId, std::unique_ptr<PeerData>> _peers;
+	PeersTable _peersTable;
 
 	MessageIdsList _mimeForwardIds;
 
@@ -0,0 +1,107 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_userpic_cache.h"
+
+#include "ui/image/image_prepare.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kUnusedLifetime = crl::time(10000);
+constexpr auto kTrimInterval = crl::time(5000);
+constexpr auto kMaxUnusedImages = 512;
+
+struct Key {
+	InMemoryKey key;
+	int size = 0;
+	int ratio = 0;
+	ImageRoundRadius radius = ImageRoundRadius();
+
+	friend inline bool operator<(const Key &a, const Key &b) {
+		return std::tie(a.key, a.size, a.ratio, a.radius)
+			< std::tie(b.key, b.size, b.ratio, b.radius);
+	}
+};
+
+struct Entry {
+	QImage image;
+	crl::time lastUsed = 0;
+};
+
+struct Cache {
+	base::flat_map<Key, Entry> entries;
+	crl::time lastTrimmed = 0;
+};
+
+[[nodiscard]] Cache &Instance() {
+	static auto result = Cache();
+	return result;
+}
+
+[[nodiscard]] bool Unused(const Entry &entry) {
+	// Only the cache itself holds this image.
+	return entry.image.isDetached();
+}
+
+void Trim(Cache &cache, crl::time now) {
+	cache.lastTrimmed = now;
+
+	auto &entries = cache.entries;
+	auto unused = std::vector<crl::time>();
+	for (auto i = begin(entries); i != end(entries);) {
+		if (!Unused(i->second)) {
+			++i;
+		} else if (now - i->second.lastUsed >= kUnusedLifetime) {
+			i = entries.erase(i);
+		} else {
+			unused.push_back(i->second.lastUsed);
+			++i;
+		}
+	}
+	if (unused.size() <= kMaxUnusedImages) {
+		return;
+	}
+	const auto drop = unused.size() - kMaxUnusedImages;
+	ranges::nth_element(unused, begin(unused) + drop);
+	const auto border = unused[drop];
+	for (auto i = begin(entries); i != end(entries);) {
+		if (Unused(i->second) && i->second.lastUsed < border) {
+			i = entries.erase(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+} // namespace
+
+QImage CachedUserpicImage(
+		InMemoryKey key,
+		int size,
+		int ratio,
+		ImageRoundRadius radius,
+		FnMut<QImage()> generate) {
+	auto &cache = Instance();
+	const auto now = crl::now();
+	const auto full = Key{ key, size, ratio, radius };
+	const auto i = cache.entries.find(full);
+	if (i != end(cache.entries)) {
+		i->second.lastUsed = now;
+		return i->second.image;
+	}
+	if (now - cache.lastTrimmed >= kTrimInterval) {
+		Trim(cache, now);
+	}
+	auto image = generate();
+	if (!image.isNull()) {
+		cache.entries.emplace(full, Entry{ image, now });
+	}
+	return image;
+}
+
+} // namespace Data
@@ -0,0 +1,27 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "ui/image/image_location.h"
+
+enum class ImageRoundRadius;
+
+namespace Data {
+
+// Rendered userpics are shared between everyone showing the same picture
+// with the same size and shape: group call members, chats list, peer lists.
+// An image stays cached while somebody still holds a copy of it (QImage is
+// implicitly shared) and for a short while after the last copy is gone.
+[[nodiscard]] QImage CachedUserpicImage(
+	InMemoryKey key,
+	int size,
+	int ratio,
+	ImageRoundRadius radius,
+	FnMut<QImage()> generate);
+
+} // namespace Data
@@ -64,6 +64,19 @@ namespace {
 
 constexpr auto kHashtagResultsLimit = 5;
 constexpr auto kStartReorderThreshold = 30;
+constexpr auto kRowCachesMargin = 2;
+
+// Whether the cached row frame still waits for a userpic or
+// for the media preview images to be downloaded.
+[[nodiscard]] bool RowLoading(not_null<const Row*> row) {
+	const auto history = row->history();
+	if (!history) {
+		return false;
+	}
+	const auto peer = history->peer;
+	return history->lastItemDialogsView.loading()
+		|| (peer->hasUserpic() && peer->useEmptyUserpic(row->userpicView()));
+}
 
 inline int DialogsRowHeight() {
 	return (::Kotato::JsonSettings::GetInt("chat_list_lines") == 1
@@ -145,13 +158,20 @@ InnerWidget::InnerWidget(
 
 	session().downloaderTaskFinished(
 	) | rpl::start_with_next([=] {
+		invalidateLoadingRowCaches();
 		update();
 	}, lifetime());
 
+	style::PaletteChanged(
+	) | rpl::start_with_next([=] {
+		clearRowCaches();
+	}, lifetime());
+
 	Core::App().notifications().settingsChanged(
 	) | rpl::start_with_next([=](Window::Notifications::ChangeType change) {
 		if (change == Window::Notifications::ChangeType::CountMessages) {
 			// Folder rows change their unread badge with this setting.
+			clearRowCaches();
 			update();
 		}
 	}, lifetime());
@@ -229,6 +249,7 @@ InnerWidget::InnerWidget(
 			stopReorderPinned();
 		}
 		if (update.flags & Data::HistoryUpdate::Flag::ChatOccupied) {
+			clearRowCaches();
 			this->update();
 			_updated.fire({});
 		}
@@ -240,6 +261,15 @@ InnerWidget::InnerWidget(
 		| UpdateFlag::Photo
 		| UpdateFlag::IsContact
 	) | rpl::start_with_next([=](const Data::PeerUpdate &update) {
+		if (update.flags & UpdateFlag::Name) {
+			// Names are shown in the message previews of other chats too.
+			clearRowCaches();
+		} else if (update.flags & UpdateFlag::Photo) {
+			if (const auto history = session().data().historyLoaded(
+					update.peer)) {
+				invalidateRowCache(history);
+			}
+		}
 		if (update.flags & (UpdateFlag::Name | UpdateFlag::Photo)) {
 			this->update();
 			_updated.fire({});
@@ -451,10 +481,9 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 				}
 				const auto isActive = (row->key() == active);
 				const auto isSelected = (row->key() == selected);
-				Ui::RowPainter::paint(
+				paintRowCached(
 					p,
 					row,
-					_filterId,
 					fullWidth,
 					isActive,
 					isSelected,
@@ -569,10 +598,9 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 						: (from == (isPressed()
 							? _filteredPressed
 							: _filteredSelected));
-					Ui::RowPainter::paint(
+					paintRowCached(
 						p,
 						_filterResults[from],
-						_filterId,
 						fullWidth,
 						active,
 						selected,
@@ -676,6 +704,108 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 	}
 }
 
+void InnerWidget::paintRowCached(
+		Painter &p,
+		not_null<const Row*> row,
+		int fullWidth,
+		bool active,
+		bool selected,
+		crl::time ms) {
+	const auto history = row->history();
+	const auto animating = row->animating()
+		|| session().supportMode()
+		|| (history && history->sendActionPainter()->animating());
+	if (animating) {
+		_rowCaches.remove(row);
+		Ui::RowPainter::paint(
+			p,
+			row,
+			_filterId,
+			fullWidth,
+			active,
+			selected,
+			ms);
+		return;
+	}
+
+	// Dates in the rows depend on the current time.
+	const auto minute = int(base::unixtime::now() / 60);
+	const auto ratio = style::DevicePixelRatio();
+	const auto size = QSize(fullWidth, DialogsRowHeight());
+	if (!_rowCaches.contains(row)) {
+		trimRowCaches(ms);
+	}
+	auto &cache = _rowCaches[row];
+	if (cache.frame.size() != size * ratio
+		|| cache.key != row->key()
+		|| cache.minute != minute
+		|| cache.active != active
+		|| cache.selected != selected) {
+		if (cache.frame.size() != size * ratio) {
+			cache.frame = QImage(
+				size * ratio,
+				QImage::Format_ARGB32_Premultiplied);
+			cache.frame.setDevicePixelRatio(ratio);
+		}
+		cache.frame.fill(Qt::transparent);
+		{
+			auto q = Painter(&cache.frame);
+			Ui::RowPainter::paint(
+				q,
+				row,
+				_filterId,
+				fullWidth,
+				active,
+				selected,
+				ms);
+		}
+		cache.key = row->key();
+		cache.loading = RowLoading(row);
+		cache.minute = minute;
+		cache.active = active;
+		cache.selected = selected;
+	}
+	cache.painted = ms;
+	p.drawImage(0, 0, cache.frame);
+}
+
+void InnerWidget::invalidateRowCache(Key key) {
+	for (auto &[row, cache] : _rowCaches) {
+		if (cache.key == key) {
+			cache.key = Key();
+		}
+	}
+}
+
+void InnerWidget::invalidateLoadingRowCaches() {
+	for (auto &[row, cache] : _rowCaches) {
+		if (cache.loading) {
+			cache.key = Key();
+		}
+	}
+}
+
+void InnerWidget::trimRowCaches(crl::time keepPainted) {
+	// Only the rows that are visible now and a few more are cached.
+	const auto visible = (_visibleBottom - _visibleTop)
+		/ DialogsRowHeight();
+	const auto limit = visible + 1 + kRowCachesMargin;
+	if (int(_rowCaches.size()) < limit) {
+		return;
+	}
+	for (auto i = begin(_rowCaches); i != end(_rowCaches);) {
+		if (i->second.painted != keepPainted) {
+			i = _rowCaches.erase(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+void InnerWidget::clearRowCaches() {
+	_rowCaches.clear();
+}
+
 void InnerWidget::paintCollapsedRows(Painter &p, QRect clip) const {
 	auto index = 0;
 	const auto rowHeight = st::dialogsImportantBarHeight;
@@ -1532,6 +1662,7 @@ int InnerWidget::defaultRowTop(not_null<Row*> row) const {
 void InnerWidget::repaintDialogRow(
 		FilterId filterId,
 		not_null<Row*> row) {
+	invalidateRowCache(row->key());
 	if (_state == WidgetState::Default) {
 		if (_filterId == filterId) {
 			if (const auto folder = row->folder()) {
@@ -1589,6 +1720,7 @@ void InnerWidget::updateDialogRow(
 		RowDescriptor row,
 		QRect updateRect,
 		UpdateRowSections sections) {
+	invalidateRowCache(row.key);
 	if (updateRect.isEmpty()) {
 		updateRect = QRect(0, 0, width(), DialogsRowHeight());
 	}
@@ -1987,6 +2119,12 @@ void InnerWidget::visibleTopBottomUpdated(
 		int visibleBottom) {
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
+	if (!_rowCaches.empty()) {
+		trimRowCaches(ranges::max(
+			_rowCaches | ranges::views::values,
+			ranges::less(),
+			&RowCache::painted).painted);
+	}
 	loadPeerPhotos();
 	if (_visibleTop + PreloadHeightsCount * (_visibleBottom - _visibleTop) >= height()) {
 		if (_loadMoreCallback) {
@@ -2217,6 +2355,7 @@ void InnerWidget::refresh(bool toTop) {
 		return refreshWithCollapsedRows(toTop);
 	}
 	refreshEmptyLabel();
+	clearRowCaches();
 	const auto list = shownDialogs();
 	auto h = 0;
 	if (_state == WidgetState::Default) {
@@ -276,6 +276,18 @@ private:
 	int searchedOffset() const;
 	int searchInChatSkip() const;
 
+	void paintRowCached(
+		Painter &p,
+		not_null<const Row*> row,
+		int fullWidth,
+		bool active,
+		bool selected,
+		crl::time ms);
+	void invalidateRowCache(Key key);
+	void invalidateLoadingRowCaches();
+	void trimRowCaches(crl::time keepPainted);
+	void clearRowCaches();
+
 	void paintCollapsedRows(
 		Painter &p,
 		QRect clip) const;
@@ -363,6 +375,17 @@ private:
 	int _visibleBottom = 0;
 	QString _filter, _hashtagFilter;
 
+	struct RowCache {
+		QImage frame;
+		Key key;
+		bool loading = false;
+		int minute = 0;
+		bool active = false;
+		bool selected = false;
+		crl::time painted = 0;
+	};
+	base::flat_map<not_null<const Row*>, RowCache> _rowCaches;
+
 	std::vector<std::unique_ptr<HashtagResult>> _hashtagResults;
 	int _hashtagSelected = -1;
 	int _hashtagPressed = -1;
@@ -131,6 +131,23 @@ void BasicRow::stopLastRipple() {
 	}
 }
 
+bool BasicRow::animating() const {
+	return _ripple
+		|| (_cornerBadgeUserpic
+			&& _cornerBadgeUserpic->animation.animating());
+}
+
+const Ui::Text::String &BasicRow::oneLineName(const QString &text) const {
+	if (_oneLineNameText != text || _oneLineName.isEmpty()) {
+		_oneLineNameText = text;
+		_oneLineName.setText(
+			st::dialogsTextStyle,
+			text,
+			Ui::NameTextOptions());
+	}
+	return _oneLineName;
+}
+
 void BasicRow::paintRipple(
 		Painter &p,
 		int x,
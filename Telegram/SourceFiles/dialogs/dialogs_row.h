@@ -58,6 +58,12 @@ public:
 		int outerWidth,
 		const QColor *colorOverride = nullptr) const;
 
+	[[nodiscard]] bool animating() const;
+
+	// Layout of the name in the one line rows, cached by its text.
+	[[nodiscard]] const Ui::Text::String &oneLineName(
+		const QString &text) const;
+
 	std::shared_ptr<Data::CloudImageView> &userpicView() const {
 		return _userpic;
 	}
@@ -83,6 +89,8 @@ private:
 	mutable std::shared_ptr<Data::CloudImageView> _userpic;
 	mutable std::unique_ptr<Ui::RippleAnimation> _ripple;
 	mutable std::unique_ptr<CornerBadgeUserpic> _cornerBadgeUserpic;
+	mutable Ui::Text::String _oneLineName;
+	mutable QString _oneLineNameText;
 	mutable bool _cornerBadgeShown = false;
 
 };
@@ -481,8 +481,11 @@ void paintOneLineRow(
 	}
 
 	if (!(from && (flags & Flag::SearchResult))) {
-		auto textStr = Ui::Text::String{ st::dialogsTextStyle, text, Ui::NameTextOptions() };
-		textStr.drawElided(p, rectForName.left(), rectForName.top(), rectForName.width());
+		row->oneLineName(text).drawElided(
+			p,
+			rectForName.left(),
+			rectForName.top(),
+			rectForName.width());
 	}
 }
 
@@ -96,6 +96,10 @@ bool MessageView::dependsOn(not_null<const HistoryItem*> item) const {
 	return (_textCachedFor == item.get());
 }
 
+bool MessageView::loading() const {
+	return (_loadingContext != nullptr);
+}
+
 void MessageView::paint(
 		Painter &p,
 		not_null<const HistoryItem*> item,
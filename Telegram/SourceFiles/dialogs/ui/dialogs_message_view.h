@@ -37,6 +37,7 @@ public:
 
 	void itemInvalidated(not_null<const HistoryItem*> item);
 	[[nodiscard]] bool dependsOn(not_null<const HistoryItem*> item) const;
+	[[nodiscard]] bool loading() const;
 
 	void paint(
 		Painter &p,
@@ -13,6 +13,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QImage>
 
+#include <deque>
+#include <mutex>
+
 #ifdef LIB_FFMPEG_USE_QT_PRIVATE_API
 #include <private/qdrawhelper_p.h>
 #endif // LIB_FFMPEG_USE_QT_PRIVATE_API
@@ -31,6 +34,87 @@ constexpr auto kMaxScaleByAspectRatio = 16;
 constexpr auto kAvioBlockSize = 4096;
 constexpr auto kTimeUnknown = std::numeric_limits<crl::time>::min();
 constexpr auto kDurationMax = crl::time(std::numeric_limits<int>::max());
+constexpr auto kMaxWarmCodecs = 4;
+constexpr auto kSkipNonRefLoopFilterScale = 2;
+
+// Opened video decoders of finished streams, flushed and ready to decode
+// another stream with the same parameters. Round videos and autoplaying
+// GIFs come and go while scrolling, opening a decoder for each is costly.
+class WarmCodecs final {
+public:
+	~WarmCodecs() {
+		for (auto context : _list) {
+			avcodec_free_context(&context);
+		}
+	}
+
+	[[nodiscard]] AVCodecContext *take(
+			not_null<const AVCodecParameters*> parameters) {
+		auto lock = std::unique_lock(_mutex);
+		const auto i = ranges::find_if(_list, [&](AVCodecContext *context) {
+			return Matches(context, parameters);
+		});
+		if (i == end(_list)) {
+			return nullptr;
+		}
+		const auto result = *i;
+		_list.erase(i);
+		return result;
+	}
+
+	[[nodiscard]] bool put(not_null<AVCodecContext*> context) {
+		if (context->codec_type != AVMEDIA_TYPE_VIDEO
+			|| !avcodec_is_open(context)
+			|| !av_codec_is_decoder(context->codec)) {
+			return false;
+		}
+		avcodec_flush_buffers(context);
+		context->skip_loop_filter = AVDISCARD_DEFAULT;
+		context->skip_frame = AVDISCARD_DEFAULT;
+
+		auto lock = std::unique_lock(_mutex);
+		_list.push_back(context);
+		auto oldest = (int(_list.size()) > kMaxWarmCodecs)
+			? _list.front()
+			: nullptr;
+		if (oldest) {
+			_list.pop_front();
+		}
+		lock.unlock();
+
+		if (oldest) {
+			avcodec_free_context(&oldest);
+		}
+		return true;
+	}
+
+private:
+	[[nodiscard]] static bool Matches(
+			not_null<const AVCodecContext*> context,
+			not_null<const AVCodecParameters*> parameters) {
+		return (context->codec_id == parameters->codec_id)
+			&& (context->codec_tag == parameters->codec_tag)
+			&& (context->profile == parameters->profile)
+			&& (context->width == parameters->width)
+			&& (context->height == parameters->height)
+			&& (context->pix_fmt == parameters->format)
+			&& (context->extradata_size == parameters->extradata_size)
+			&& (!context->extradata_size
+				|| !memcmp(
+					context->extradata,
+					parameters->extradata,
+					context->extradata_size));
+	}
+
+	std::mutex _mutex;
+	std::deque<AVCodecContext*> _list;
+
+};
+
+[[nodiscard]] WarmCodecs &GetWarmCodecs() {
+	static auto result = WarmCodecs();
+	return result;
+}
 
 void AlignedImageBufferCleanupHandler(void* data) {
 	const auto buffer = static_cast<uchar*>(data);
@@ -165,6 +249,13 @@ AVCodec *FindDecoder(not_null<AVCodecContext*> context) {
 CodecPointer MakeCodecPointer(not_null<AVStream*> stream) {
 	auto error = AvErrorWrap();
 
+	if (stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+		if (const auto warm = GetWarmCodecs().take(stream->codecpar)) {
+			warm->pkt_timebase = stream->time_base;
+			return CodecPointer(warm);
+		}
+	}
+
 	auto result = CodecPointer(avcodec_alloc_context3(nullptr));
 	const auto context = result.get();
 	if (!context) {
@@ -198,7 +289,7 @@ CodecPointer MakeCodecPointer(not_null<AVStream*> stream) {
 }
 
 void CodecDeleter::operator()(AVCodecContext *value) {
-	if (value) {
+	if (value && !GetWarmCodecs().put(value)) {
 		avcodec_free_context(&value);
 	}
 }
@@ -368,6 +459,22 @@ bool RotationSwapWidthHeight(int rotation) {
 	return (rotation == 90 || rotation == 270);
 }
 
+AVDiscard SkipLoopFilterFor(QSize decoded, QSize shown) {
+	if (decoded.isEmpty() || shown.isEmpty()) {
+		return AVDISCARD_DEFAULT;
+	}
+	// Compare the smaller sides, so that rotation doesn't matter.
+	const auto scale = std::min(decoded.width(), decoded.height())
+		/ std::max(std::min(shown.width(), shown.height()), 1);
+
+	// Never skip it for the reference frames: the next frames are
+	// predicted from the filtered ones, so the artifacts would add up
+	// until the next keyframe, and looped GIFs often have long GOPs.
+	return (scale >= kSkipNonRefLoopFilterScale)
+		? AVDISCARD_NONREF
+		: AVDISCARD_DEFAULT;
+}
+
 bool GoodStorageForFrame(const QImage &storage, QSize size) {
 	return !storage.isNull()
 		&& (storage.format() == kImageFormat)
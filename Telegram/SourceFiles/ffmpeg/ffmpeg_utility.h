@@ -177,6 +177,11 @@ void LogError(QLatin1String method, FFmpeg::AvErrorWrap error);
 [[nodiscard]] bool RotationSwapWidthHeight(int rotation);
 [[nodiscard]] QSize CorrectByAspect(QSize size, AVRational aspect);
 
+// Deblocking artifacts are not visible when a frame is shown much
+// smaller than it is decoded, so the loop filter may be skipped for
+// the frames that are not used as references.
+[[nodiscard]] AVDiscard SkipLoopFilterFor(QSize decoded, QSize shown);
+
 [[nodiscard]] bool GoodStorageForFrame(const QImage &storage, QSize size);
 [[nodiscard]] QImage CreateFrameStorage(QSize size);
 
@@ -1218,8 +1218,17 @@ MessageGroupId HistoryItem::groupId() const {
 	return _groupId;
 }
 
+TextWithEntities HistoryItem::textWithEntities() const {
+	return _compactText
+		? TextWithEntities{
+			QString::fromUtf8(_compactText->utf8),
+			_compactText->entities,
+		}
+		: _text.toTextWithEntities();
+}
+
 bool HistoryItem::isEmpty() const {
-	return _text.isEmpty()
+	return emptyText()
 		&& !_media
 		&& !Has<HistoryMessageLogEntryOriginal>();
 }
@@ -1229,7 +1238,7 @@ TextWithEntities HistoryItem::notificationText() const {
 		if (_media/* && !isService()*/) {
 			return _media->notificationText();
 		} else if (!emptyText()) {
-			return _text.toTextWithEntities();
+			return textWithEntities();
 		}
 		return TextWithEntities();
 	}();
@@ -1246,7 +1255,7 @@ ItemPreview HistoryItem::toPreview(ToPreviewOptions options) const {
 			return _media->toPreview(options);
 		} else if (!emptyText()) {
 			return {
-				.text = _text.toTextWithEntities()
+				.text = textWithEntities()
 			};
 		}
 		return {};
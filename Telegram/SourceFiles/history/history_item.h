@@ -344,8 +344,15 @@ public:
 	virtual void hideSpoilers() {
 	}
 
+	// While no view displays the message its laid out text is dropped
+	// and only the original text is kept, see Data::Session::_views.
+	virtual void compactText() {
+	}
+	virtual void expandText() {
+	}
+
 	[[nodiscard]] bool emptyText() const {
-		return _text.isEmpty();
+		return _text.isEmpty() && !_compactText;
 	}
 
 	[[nodiscard]] bool canPin() const;
@@ -469,7 +476,21 @@ protected:
 	void applyTTL(const MTPDmessageService &data);
 	void applyTTL(TimeId destroyAt);
 
+	struct CompactText {
+		QByteArray utf8;
+		EntitiesInText entities;
+
+		// Computed from the laid out text before it was dropped.
+		Ui::Text::IsolatedEmoji isolatedEmoji;
+		bool hasLinks = false;
+
+		// Laid out again only once, when first requested.
+		mutable std::optional<TextForMimeData> clipboard;
+	};
+	[[nodiscard]] TextWithEntities textWithEntities() const;
+
 	Ui::Text::String _text = { st::msgMinWidth };
+	std::unique_ptr<CompactText> _compactText;
 	int _textWidth = -1;
 	int _textHeight = 0;
 
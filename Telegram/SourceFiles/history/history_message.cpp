@@ -1069,6 +1069,46 @@ void HistoryMessage::hideSpoilers() {
 	HistoryView::HideSpoilers(_text);
 }
 
+void HistoryMessage::compactText() {
+	if (_compactText
+		|| emptyText()
+		|| (_flags & MessageFlag::IsolatedEmoji)) {
+		return;
+	}
+	auto original = _text.toTextWithEntities();
+	_compactText = std::make_unique<CompactText>(CompactText{
+		.utf8 = original.text.toUtf8(),
+		.entities = std::move(original.entities),
+		.isolatedEmoji = _text.toIsolatedEmoji(),
+		.hasLinks = _text.hasLinks(),
+	});
+	_text = Ui::Text::String(st::msgMinWidth);
+	_textWidth = -1;
+	_textHeight = 0;
+}
+
+void HistoryMessage::expandText() {
+	if (_compactText) {
+		setText(textWithEntities());
+	}
+}
+
+Ui::Text::String HistoryMessage::layoutCompactText() const {
+	Expects(_compactText != nullptr);
+
+	auto result = Ui::Text::String(st::msgMinWidth);
+	const auto context = Core::MarkedTextContext{
+		.session = &history()->session()
+	};
+	result.setMarkedText(
+		st::messageTextStyle,
+		withLocalEntities(textWithEntities()),
+		Ui::ItemTextOptions(this),
+		context);
+	HistoryView::FillTextWithAnimatedSpoilers(result);
+	return result;
+}
+
 bool HistoryMessage::updateDependencyItem() {
 	if (const auto reply = Get<HistoryMessageReply>()) {
 		const auto documentId = reply->replyToDocumentId;
@@ -1704,6 +1744,7 @@ void HistoryMessage::setText(const TextWithEntities &textWithEntities) {
 		return;
 	}
 
+	_compactText = nullptr;
 	clearIsolatedEmoji();
 	const auto context = Core::MarkedTextContext{
 		.session = &history()->session()
@@ -1735,6 +1776,7 @@ void HistoryMessage::reapplyText() {
 }
 
 void HistoryMessage::setEmptyText() {
+	_compactText = nullptr;
 	clearIsolatedEmoji();
 	_text.setMarkedText(
 		st::messageTextStyle,
@@ -1805,14 +1847,16 @@ void HistoryMessage::setReplyMarkup(HistoryMessageMarkupData &&markup) {
 }
 
 Ui::Text::IsolatedEmoji HistoryMessage::isolatedEmoji() const {
-	return _text.toIsolatedEmoji();
+	return _compactText
+		? _compactText->isolatedEmoji
+		: _text.toIsolatedEmoji();
 }
 
 TextWithEntities HistoryMessage::originalText() const {
 	if (emptyText()) {
 		return { QString(), EntitiesInText() };
 	}
-	return _text.toTextWithEntities();
+	return textWithEntities();
 }
 
 TextWithEntities HistoryMessage::originalTextWithLocalEntities() const {
@@ -1822,12 +1866,22 @@ TextWithEntities HistoryMessage::originalTextWithLocalEntities() const {
 TextForMimeData HistoryMessage::clipboardText() const {
 	if (emptyText()) {
 		return TextForMimeData();
+	} else if (_compactText) {
+		auto &clipboard = _compactText->clipboard;
+		if (!clipboard) {
+			clipboard = layoutCompactText().toTextForMimeData();
+		}
+		return *clipboard;
 	}
 	return _text.toTextForMimeData();
 }
 
 bool HistoryMessage::textHasLinks() const {
-	return emptyText() ? false : _text.hasLinks();
+	return emptyText()
+		? false
+		: _compactText
+		? _compactText->hasLinks
+		: _text.hasLinks();
 }
 
 bool HistoryMessage::changeViewsCount(int count) {
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "history/history_item.h"
+#include "history/history_slab_allocator.h"
 
 namespace Api {
 struct SendAction;
@@ -55,6 +56,13 @@ void FastShareMessage(not_null<HistoryItem*> item);
 
 class HistoryMessage final : public HistoryItem {
 public:
+	static void *operator new(std::size_t size) {
+		return HistorySlabNew<HistoryMessage>(size);
+	}
+	static void operator delete(void *block, std::size_t size) {
+		HistorySlabDelete<HistoryMessage>(block, size);
+	}
+
 	HistoryMessage(
 		not_null<History*> history,
 		MsgId id,
@@ -215,6 +223,8 @@ public:
 		return replyToId();
 	}
 	void hideSpoilers() override;
+	void compactText() override;
+	void expandText() override;
 
 	void applySentMessage(const MTPDmessage &data) override;
 	void applySentMessage(
@@ -230,6 +240,7 @@ public:
 
 private:
 	void setEmptyText();
+	[[nodiscard]] Ui::Text::String layoutCompactText() const;
 	[[nodiscard]] bool isTooOldForEdit(TimeId now) const;
 	[[nodiscard]] bool isLegacyMessage() const {
 		return _flags & MessageFlag::Legacy;
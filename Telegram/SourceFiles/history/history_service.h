@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "history/history_item.h"
+#include "history/history_slab_allocator.h"
 
 namespace HistoryView {
 class Service;
@@ -62,6 +63,13 @@ class ServiceMessagePainter;
 
 class HistoryService : public HistoryItem {
 public:
+	static void *operator new(std::size_t size) {
+		return HistorySlabNew<HistoryService>(size);
+	}
+	static void operator delete(void *block, std::size_t size) {
+		HistorySlabDelete<HistoryService>(block, size);
+	}
+
 	struct PreparedText {
 		TextWithEntities text;
 		QList<ClickHandlerPtr> links;
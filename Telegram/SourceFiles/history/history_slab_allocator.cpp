@@ -0,0 +1,87 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "history/history_slab_allocator.h"
+
+namespace {
+
+[[nodiscard]] std::size_t BlockSize(std::size_t size) {
+	constexpr auto kAlign = alignof(std::max_align_t);
+	return ((std::max(size, sizeof(void*)) + kAlign - 1) / kAlign) * kAlign;
+}
+
+} // namespace
+
+HistorySlabAllocator::HistorySlabAllocator(std::size_t size, int perSlab)
+: _size(BlockSize(size))
+, _perSlab(perSlab) {
+	Expects(_perSlab > 0);
+}
+
+HistorySlabAllocator::~HistorySlabAllocator() {
+	if (_allocated > 0) {
+		// Some objects outlive the static allocator on quit, leave them be.
+		for (auto &[data, slab] : _slabs) {
+			slab.data.release();
+		}
+	}
+}
+
+void *HistorySlabAllocator::allocate() {
+	if (_withFree.empty()) {
+		addSlab();
+	}
+
+	// Fill the slabs with lower addresses first,
+	// so that the others have a chance to become empty.
+	const auto i = _withFree.begin();
+	const auto slab = i->second;
+	const auto result = slab->free;
+	slab->free = result->next;
+	if (!slab->free) {
+		_withFree.erase(i);
+	}
+	++slab->used;
+	++_allocated;
+	result->~FreeBlock();
+	return result;
+}
+
+void HistorySlabAllocator::free(void *block) {
+	Expects(_allocated > 0);
+
+	const auto address = static_cast<std::byte*>(block);
+	auto i = _slabs.upper_bound(address);
+	Assert(i != _slabs.begin());
+	--i;
+	auto &slab = i->second;
+	Assert(address < i->first + _size * _perSlab);
+	Assert(slab.used > 0);
+
+	--_allocated;
+	const auto wasFull = !slab.free;
+	slab.free = new (block) FreeBlock{ slab.free };
+	if (wasFull) {
+		// Only a full slab is missing from _withFree.
+		_withFree.emplace(i->first, &slab);
+	}
+	if (!--slab.used && _withFree.size() > 1) {
+		_withFree.erase(i->first);
+		_slabs.erase(i);
+	}
+}
+
+void HistorySlabAllocator::addSlab() {
+	// operator new[] for std::byte returns memory aligned to max_align_t.
+	auto slab = Slab{ std::make_unique<std::byte[]>(_size * _perSlab) };
+	const auto data = slab.data.get();
+	for (auto i = _perSlab; i != 0;) {
+		slab.free = new (data + (--i) * _size) FreeBlock{ slab.free };
+	}
+	const auto i = _slabs.emplace(data, std::move(slab)).first;
+	_withFree.emplace(data, &i->second);
+}
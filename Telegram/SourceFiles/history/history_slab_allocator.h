@@ -0,0 +1,85 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+// Hands out fixed size blocks carved from large slabs, so that loading
+// thousands of messages doesn't do a separate malloc for each of them.
+// A slab is released as soon as all its blocks are freed, only one empty
+// slab is kept around to not allocate it again right away.
+//
+// Main thread only, like all the history items and views.
+class HistorySlabAllocator final {
+public:
+	HistorySlabAllocator(std::size_t size, int perSlab);
+	HistorySlabAllocator(const HistorySlabAllocator &other) = delete;
+	HistorySlabAllocator &operator=(
+		const HistorySlabAllocator &other) = delete;
+	~HistorySlabAllocator();
+
+	[[nodiscard]] std::size_t size() const {
+		return _size;
+	}
+
+	[[nodiscard]] void *allocate();
+	void free(void *block);
+
+private:
+	struct FreeBlock {
+		FreeBlock *next = nullptr;
+	};
+	struct Slab {
+		std::unique_ptr<std::byte[]> data;
+		FreeBlock *free = nullptr;
+		int used = 0;
+	};
+
+	void addSlab();
+
+	const std::size_t _size = 0;
+	const int _perSlab = 0;
+	std::map<std::byte*, Slab> _slabs;
+	std::map<std::byte*, not_null<Slab*>> _withFree;
+	int _allocated = 0;
+
+};
+
+// Use inside a class with a virtual destructor:
+//
+// static void *operator new(std::size_t size) {
+//     return HistorySlabNew<Class>(size);
+// }
+// static void operator delete(void *block, std::size_t size) {
+//     HistorySlabDelete<Class>(block, size);
+// }
+//
+// Derived classes of a different size fall back to the global heap.
+template <typename Type>
+[[nodiscard]] HistorySlabAllocator &HistorySlabFor() {
+	constexpr auto kSlabSize = 64 * 1024;
+	constexpr auto kPerSlab = std::max(
+		int(kSlabSize / sizeof(Type)),
+		16);
+	static auto result = HistorySlabAllocator(sizeof(Type), kPerSlab);
+	return result;
+}
+
+template <typename Type>
+[[nodiscard]] void *HistorySlabNew(std::size_t size) {
+	return (size == sizeof(Type))
+		? HistorySlabFor<Type>().allocate()
+		: ::operator new(size);
+}
+
+template <typename Type>
+void HistorySlabDelete(void *block, std::size_t size) {
+	if (size == sizeof(Type)) {
+		HistorySlabFor<Type>().free(block);
+	} else {
+		::operator delete(block);
+	}
+}
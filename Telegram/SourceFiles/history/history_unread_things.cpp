@@ -63,6 +63,9 @@ void Proxy::setCount(int count) {
 		}
 		_history->updateChatListEntry();
 	}
+	if (has && !list.loadedCount()) {
+		_history->session().api().unreadThings().prefetch(_history);
+	}
 }
 
 bool Proxy::add(MsgId msgId, AddType type) {
@@ -4241,9 +4241,7 @@ void HistoryWidget::chooseAttach() {
 				uploadFile(result.remoteContent, SendMediaType::File);
 			}
 		} else {
-			auto list = Storage::PrepareMediaList(
-				result.paths,
-				st::sendMediaPreviewSize);
+			auto list = prepareMediaList(result.paths);
 			confirmSendingFiles(std::move(list));
 		}
 	}), nullptr);
@@ -5045,9 +5043,22 @@ bool HistoryWidget::confirmSendingFiles(not_null<const QMimeData*> data) {
 bool HistoryWidget::confirmSendingFiles(
 		const QStringList &files,
 		const QString &insertTextOnCancel) {
-	return confirmSendingFiles(
-		Storage::PrepareMediaList(files, st::sendMediaPreviewSize),
-		insertTextOnCancel);
+	return confirmSendingFiles(prepareMediaList(files), insertTextOnCancel);
+}
+
+Ui::PreparedList HistoryWidget::prepareMediaList(
+		const QStringList &files) const {
+	// In slowmode the details are needed to check whether it can be sent.
+	return _peer->slowmodeApplied()
+		? Storage::PrepareMediaList(files, st::sendMediaPreviewSize)
+		: Storage::PrepareMediaListDeferred(files);
+}
+
+Ui::PreparedList HistoryWidget::prepareMediaList(
+		const QList<QUrl> &files) const {
+	return _peer->slowmodeApplied()
+		? Storage::PrepareMediaList(files, st::sendMediaPreviewSize)
+		: Storage::PrepareMediaListDeferred(files);
 }
 
 bool HistoryWidget::confirmSendingFiles(
@@ -5188,9 +5199,7 @@ bool HistoryWidget::confirmSendingFiles(
 	const auto hasImage = data->hasImage();
 
 	if (const auto urls = data->urls(); !urls.empty()) {
-		auto list = Storage::PrepareMediaList(
-			urls,
-			st::sendMediaPreviewSize);
+		auto list = prepareMediaList(urls);
 		if (list.error != Ui::PreparedList::Error::NonLocalUrl) {
 			if (list.error == Ui::PreparedList::Error::None
 				|| !hasImage) {
@@ -457,6 +457,10 @@ private:
 		Ui::PreparedList &&list,
 		const QString &insertTextOnCancel = QString());
 	bool showSendingFilesError(const Ui::PreparedList &list) const;
+	[[nodiscard]] Ui::PreparedList prepareMediaList(
+		const QStringList &files) const;
+	[[nodiscard]] Ui::PreparedList prepareMediaList(
+		const QList<QUrl> &files) const;
 
 	void sendingFilesConfirmed(
 		Ui::PreparedList &&list,
@@ -30,6 +30,8 @@ constexpr auto kMaxPlays = 5;
 constexpr auto kMaxPlaysWithSmallDelay = 3;
 constexpr auto kSmallDelay = crl::time(200);
 constexpr auto kDropDelayedAfterDelay = crl::time(2000);
+constexpr auto kKeepUnusedProvider = 30 * crl::time(1000);
+constexpr auto kMaxUnusedProviders = 3;
 
 [[nodiscard]] QPoint GenerateRandomShift(QSize emoji) {
 	// Random shift in [-0.08 ... 0.08] of animated emoji size.
@@ -43,7 +45,8 @@ constexpr auto kDropDelayedAfterDelay = crl::time(2000);
 } // namespace
 
 EmojiInteractions::EmojiInteractions(not_null<Main::Session*> session)
-: _session(session) {
+: _session(session)
+, _clearProvidersTimer([=] { clearOldProviders(); }) {
 	_session->data().viewRemoved(
 	) | rpl::filter([=] {
 		return !_plays.empty() || !_delayed.empty();
@@ -154,24 +157,61 @@ std::unique_ptr<Lottie::SinglePlayer> EmojiInteractions::preparePlayer(
 	const auto request = Lottie::FrameRequest{
 		_emojiSize * kSizeMultiplier * style::DevicePixelRatio(),
 	};
-	auto &weakProvider = _sharedProviders[document];
-	auto shared = [&] {
-		if (const auto result = weakProvider.lock()) {
-			return result;
-		}
-		const auto result = Lottie::SinglePlayer::SharedProvider(
+	auto &provider = _sharedProviders[document];
+	if (!provider.provider) {
+		provider.provider = Lottie::SinglePlayer::SharedProvider(
 			kCachesCount,
 			get,
 			put,
 			Lottie::ReadContent(data, filepath),
 			request,
 			Lottie::Quality::High);
-		weakProvider = result;
-		return result;
-	}();
+	}
+	provider.lastUsed = crl::now();
+	auto shared = provider.provider;
+	limitUnusedProviders();
+	if (!_clearProvidersTimer.isActive()) {
+		_clearProvidersTimer.callEach(kKeepUnusedProvider);
+	}
 	return std::make_unique<Lottie::SinglePlayer>(std::move(shared), request);
 }
 
+void EmojiInteractions::limitUnusedProviders() {
+	// A provider is unused if only this cache holds a reference to it.
+	auto unused = std::vector<std::pair<crl::time, not_null<DocumentData*>>>();
+	for (const auto &[document, provider] : _sharedProviders) {
+		if (provider.provider.use_count() == 1) {
+			unused.emplace_back(provider.lastUsed, document);
+		}
+	}
+	if (int(unused.size()) <= kMaxUnusedProviders) {
+		return;
+	}
+	ranges::sort(unused, [](const auto &a, const auto &b) {
+		return (a.first < b.first);
+	});
+	unused.resize(unused.size() - kMaxUnusedProviders);
+	for (const auto &[lastUsed, document] : unused) {
+		_sharedProviders.remove(document);
+	}
+}
+
+void EmojiInteractions::clearOldProviders() {
+	const auto now = crl::now();
+	for (auto i = begin(_sharedProviders); i != end(_sharedProviders);) {
+		const auto &provider = i->second;
+		if (provider.provider.use_count() == 1
+			&& provider.lastUsed + kKeepUnusedProvider <= now) {
+			i = _sharedProviders.erase(i);
+		} else {
+			++i;
+		}
+	}
+	if (_sharedProviders.empty()) {
+		_clearProvidersTimer.cancel();
+	}
+}
+
 void EmojiInteractions::visibleAreaUpdated(
 		int visibleTop,
 		int visibleBottom) {
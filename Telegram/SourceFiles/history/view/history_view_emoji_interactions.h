@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/timer.h"
+
 namespace Data {
 class DocumentMedia;
 } // namespace Data
@@ -52,6 +54,10 @@ private:
 		int frameRate = 0;
 		bool finished = false;
 	};
+	struct Provider {
+		std::shared_ptr<Lottie::FrameProvider> provider;
+		crl::time lastUsed = 0;
+	};
 	struct Delayed {
 		QString emoticon;
 		not_null<Element*> view;
@@ -71,6 +77,8 @@ private:
 
 	[[nodiscard]] std::unique_ptr<Lottie::SinglePlayer> preparePlayer(
 		not_null<Data::DocumentMedia*> media);
+	void limitUnusedProviders();
+	void clearOldProviders();
 
 	const not_null<Main::Session*> _session;
 
@@ -82,9 +90,15 @@ private:
 	std::vector<Delayed> _delayed;
 	rpl::event_stream<QRect> _updateRequests;
 	rpl::event_stream<QString> _playStarted;
-	base::flat_map<
-		not_null<DocumentData*>,
-		std::weak_ptr<Lottie::FrameProvider>> _sharedProviders;
+
+	// Parsed animations are kept for some time after the plays finish,
+	// so that repeated interactions don't parse the same JSON again.
+	// Interactions have no colour replacements, so the document is
+	// the key. Stickers and large emoji don't go through this cache,
+	// their players live as long as the view and restore from the
+	// complete frame cache in cacheBigFile() without parsing.
+	base::flat_map<not_null<DocumentData*>, Provider> _sharedProviders;
+	base::Timer _clearProvidersTimer;
 
 	rpl::lifetime _lifetime;
 
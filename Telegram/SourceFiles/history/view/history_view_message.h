@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "history/view/history_view_element.h"
 #include "history/view/history_view_bottom_info.h"
+#include "history/history_slab_allocator.h"
 #include "ui/effects/animations.h"
 #include "base/weak_ptr.h"
 
@@ -45,6 +46,13 @@ struct PsaTooltipState : public RuntimeComponent<PsaTooltipState, Element> {
 
 class Message : public Element, public base::has_weak_ptr {
 public:
+	static void *operator new(std::size_t size) {
+		return HistorySlabNew<Message>(size);
+	}
+	static void operator delete(void *block, std::size_t size) {
+		HistorySlabDelete<Message>(block, size);
+	}
+
 	Message(
 		not_null<ElementDelegate*> delegate,
 		not_null<HistoryMessage*> data,
@@ -653,9 +653,7 @@ void RepliesWidget::chooseAttach() {
 				uploadFile(result.remoteContent, SendMediaType::File);
 			}
 		} else {
-			auto list = Storage::PrepareMediaList(
-				result.paths,
-				st::sendMediaPreviewSize);
+			auto list = prepareMediaList(result.paths);
 			confirmSendingFiles(std::move(list));
 		}
 	}), nullptr);
@@ -668,9 +666,7 @@ bool RepliesWidget::confirmSendingFiles(
 	const auto hasImage = data->hasImage();
 
 	if (const auto urls = data->urls(); !urls.empty()) {
-		auto list = Storage::PrepareMediaList(
-			urls,
-			st::sendMediaPreviewSize);
+		auto list = prepareMediaList(urls);
 		if (list.error != Ui::PreparedList::Error::NonLocalUrl) {
 			if (list.error == Ui::PreparedList::Error::None
 				|| !hasImage) {
@@ -696,6 +692,21 @@ bool RepliesWidget::confirmSendingFiles(
 	return false;
 }
 
+Ui::PreparedList RepliesWidget::prepareMediaList(
+		const QStringList &files) const {
+	// In slowmode the details are needed to check whether it can be sent.
+	return _history->peer->slowmodeApplied()
+		? Storage::PrepareMediaList(files, st::sendMediaPreviewSize)
+		: Storage::PrepareMediaListDeferred(files);
+}
+
+Ui::PreparedList RepliesWidget::prepareMediaList(
+		const QList<QUrl> &files) const {
+	return _history->peer->slowmodeApplied()
+		? Storage::PrepareMediaList(files, st::sendMediaPreviewSize)
+		: Storage::PrepareMediaListDeferred(files);
+}
+
 bool RepliesWidget::confirmSendingFiles(
 		Ui::PreparedList &&list,
 		const QString &insertTextOnCancel) {
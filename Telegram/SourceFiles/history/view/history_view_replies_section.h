@@ -237,6 +237,10 @@ private:
 		std::optional<bool> overrideSendImagesAsPhotos = std::nullopt,
 		const QString &insertTextOnCancel = QString());
 	bool showSendingFilesError(const Ui::PreparedList &list) const;
+	[[nodiscard]] Ui::PreparedList prepareMediaList(
+		const QStringList &files) const;
+	[[nodiscard]] Ui::PreparedList prepareMediaList(
+		const QList<QUrl> &files) const;
 	void sendingFilesConfirmed(
 		Ui::PreparedList &&list,
 		Ui::SendFilesWay way,
@@ -349,9 +349,7 @@ void ScheduledWidget::chooseAttach() {
 				uploadFile(result.remoteContent, SendMediaType::File);
 			}
 		} else {
-			auto list = Storage::PrepareMediaList(
-				result.paths,
-				st::sendMediaPreviewSize);
+			auto list = Storage::PrepareMediaListDeferred(result.paths);
 			confirmSendingFiles(std::move(list));
 		}
 	}), nullptr);
@@ -364,9 +362,7 @@ bool ScheduledWidget::confirmSendingFiles(
 	const auto hasImage = data->hasImage();
 
 	if (const auto urls = data->urls(); !urls.empty()) {
-		auto list = Storage::PrepareMediaList(
-			urls,
-			st::sendMediaPreviewSize);
+		auto list = Storage::PrepareMediaListDeferred(urls);
 		if (list.error != Ui::PreparedList::Error::NonLocalUrl) {
 			if (list.error == Ui::PreparedList::Error::None
 				|| !hasImage) {
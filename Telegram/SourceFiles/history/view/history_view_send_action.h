@@ -43,6 +43,9 @@ public:
 		style::color color,
 		crl::time now);
 
+	[[nodiscard]] bool animating() const {
+		return !!_sendActionAnimation;
+	}
 	bool updateNeedsAnimating(
 		crl::time now,
 		bool force = false);
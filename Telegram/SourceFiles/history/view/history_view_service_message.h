@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "history/view/history_view_element.h"
+#include "history/history_slab_allocator.h"
 
 class HistoryService;
 
@@ -20,6 +21,13 @@ namespace HistoryView {
 
 class Service : public Element {
 public:
+	static void *operator new(std::size_t size) {
+		return HistorySlabNew<Service>(size);
+	}
+	static void operator delete(void *block, std::size_t size) {
+		HistorySlabDelete<Service>(block, size);
+	}
+
 	Service(
 		not_null<ElementDelegate*> delegate,
 		not_null<HistoryService*> data,
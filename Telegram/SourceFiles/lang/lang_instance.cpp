@@ -211,6 +211,17 @@ void ParseKeyValue(
 	}
 }
 
+[[nodiscard]] std::optional<QString> ParseValue(
+		const QByteArray &key,
+		ushort index,
+		const QByteArray &value) {
+	ValueParser parser(key, index, value);
+	if (!parser.parse()) {
+		return std::nullopt;
+	}
+	return parser.takeResult();
+}
+
 } // namespace
 
 QString DefaultLanguageId() {
@@ -244,17 +255,20 @@ struct Instance::PrivateTag {
 
 Instance::Instance()
 : _values(PrepareDefaultValues())
+, _failedValues(kKeysCount, 0)
 , _nonDefaultSet(kKeysCount, 0) {
 }
 
 Instance::Instance(not_null<Instance*> derived, const PrivateTag &)
 : _derived(derived)
+, _failedValues(kKeysCount, 0)
 , _nonDefaultSet(kKeysCount, 0) {
 }
 
 void Instance::switchToId(const Language &data) {
 	reset(data);
 	if (_id == qstr("#TEST_X") || _id == qstr("#TEST_0")) {
+		parsePendingValues();
 		for (auto &value : _values) {
 			value = PrepareTestValue(value, _id[5]);
 		}
@@ -303,6 +317,12 @@ void Instance::reset(const Language &data) {
 	for (auto i = 0, count = int(_values.size()); i != count; ++i) {
 		_values[i] = GetOriginalValue(ushort(i));
 	}
+	{
+		QMutexLocker lock(&_pendingMutex);
+		_pendingValues.clear();
+		_pendingCount = 0;
+		ranges::fill(_failedValues, 0);
+	}
 	ranges::fill(_nonDefaultSet, 0);
 	updateChoosingStickerReplacement();
 
@@ -735,22 +755,114 @@ QString Instance::getNonDefaultValue(const QByteArray &key) const {
 
 void Instance::applyValue(const QByteArray &key, const QByteArray &value) {
 	_nonDefaultValues[key] = value;
-	ParseKeyValue(key, value, [&](ushort key, QString &&value) {
-		_nonDefaultSet[key] = 1;
-		if (!_derived) {
-			_values[key] = std::move(value);
-		} else if (!_derived->_nonDefaultSet[key]) {
-			_derived->_values[key] = std::move(value);
+	const auto index = GetKeyIndex(QLatin1String(key));
+	if (index == kKeysCount) {
+		if (!key.startsWith("cloud_")) {
+			DEBUG_LOG(("Lang Warning: Unknown key '%1'"
+				).arg(QString::fromLatin1(key)));
 		}
-		if (key == tr::lng_send_action_choose_sticker.base
-			|| key == tr::lng_user_action_choose_sticker.base) {
-			if (!_derived) {
-				updateChoosingStickerReplacement();
-			} else {
-				_derived->updateChoosingStickerReplacement();
+		return;
+	}
+	_nonDefaultSet[index] = 1;
+	if (!_derived) {
+		const auto fallback = [&] {
+			if (!_base) {
+				return QByteArray();
 			}
+			const auto &values = _base->_nonDefaultValues;
+			const auto i = values.find(key);
+			return (i != end(values)) ? i->second : QByteArray();
+		}();
+		setPendingValue(index, key, value, fallback);
+	} else if (!_derived->_nonDefaultSet[index]) {
+		_derived->setPendingValue(index, key, value, QByteArray());
+	} else {
+		_derived->setPendingFallback(index, key, value);
+	}
+	if (index == tr::lng_send_action_choose_sticker.base
+		|| index == tr::lng_user_action_choose_sticker.base) {
+		if (!_derived) {
+			updateChoosingStickerReplacement();
+		} else {
+			_derived->updateChoosingStickerReplacement();
 		}
-	});
+	}
+}
+
+void Instance::setPendingValue(
+		ushort index,
+		const QByteArray &key,
+		const QByteArray &value,
+		const QByteArray &fallback) {
+	QMutexLocker lock(&_pendingMutex);
+	if (_pendingValues.empty()) {
+		_pendingValues.resize(kKeysCount);
+	}
+	auto &pending = _pendingValues[index];
+	if (pending.key.isEmpty()) {
+		++_pendingCount;
+	}
+	pending = { key, value, fallback };
+	_failedValues[index] = 0;
+}
+
+void Instance::setPendingFallback(
+		ushort index,
+		const QByteArray &key,
+		const QByteArray &fallback) {
+	QMutexLocker lock(&_pendingMutex);
+	if (_pendingCount > 0 && !_pendingValues[index].key.isEmpty()) {
+		_pendingValues[index].fallback = fallback;
+	} else if (_failedValues[index]) {
+		// Our own value is broken, show the new base value instead.
+		if (_pendingValues.empty()) {
+			_pendingValues.resize(kKeysCount);
+		}
+		_pendingValues[index] = { key, fallback, QByteArray() };
+		_failedValues[index] = 0;
+		++_pendingCount;
+	}
+}
+
+void Instance::dropPendingValue(ushort index) {
+	QMutexLocker lock(&_pendingMutex);
+	_failedValues[index] = 0;
+	if (_pendingCount > 0 && !_pendingValues[index].key.isEmpty()) {
+		_pendingValues[index] = PendingValue();
+		if (!--_pendingCount) {
+			_pendingValues.clear();
+		}
+	}
+}
+
+void Instance::parsePendingValue(ushort index) const {
+	// Strings may be requested from any thread.
+	QMutexLocker lock(&_pendingMutex);
+	if (_pendingValues.empty() || _pendingValues[index].key.isEmpty()) {
+		return;
+	}
+	const auto pending = base::take(_pendingValues[index]);
+	if (auto parsed = ParseValue(pending.key, index, pending.value)) {
+		_values[index] = std::move(*parsed);
+	} else if (auto fallback = pending.fallback.isEmpty()
+			? std::nullopt
+			: ParseValue(pending.key, index, pending.fallback)) {
+		// A value that failed to parse is replaced by the base one.
+		_values[index] = std::move(*fallback);
+	} else {
+		// Without a valid base value the key doesn't count as set.
+		_values[index] = GetOriginalValue(index);
+		_failedValues[index] = 1;
+	}
+	if (!--_pendingCount) {
+		_pendingValues.clear();
+	}
+}
+
+void Instance::parsePendingValues() const {
+	for (auto i = 0; _pendingCount > 0 && i != kKeysCount; ++i) {
+		parsePendingValue(ushort(i));
+	}
 }
 
 void Instance::updatePluralRules() {
@@ -771,6 +883,7 @@ void Instance::resetValue(const QByteArray &key) {
 	if (keyIndex != kKeysCount) {
 		_nonDefaultSet[keyIndex] = 0;
 		if (!_derived) {
+			dropPendingValue(keyIndex);
 			const auto base = _base
 				? _base->getNonDefaultValue(key)
 				: QString();
@@ -778,6 +891,7 @@ void Instance::resetValue(const QByteArray &key) {
 				? base
 				: GetOriginalValue(keyIndex);
 		} else if (!_derived->_nonDefaultSet[keyIndex]) {
+			_derived->dropPendingValue(keyIndex);
 			_derived->_values[keyIndex] = GetOriginalValue(keyIndex);
 		}
 		if (keyIndex == tr::lng_send_action_choose_sticker.base
@@ -58,8 +58,8 @@ public:
 
 	Instance(const Instance &other) = delete;
 	Instance &operator=(const Instance &other) = delete;
-	Instance(Instance &&other) = default;
-	Instance &operator=(Instance &&other) = default;
+	Instance(Instance &&other) = delete;
+	Instance &operator=(Instance &&other) = delete;
 
 	QString systemLangCode() const;
 	QString langPackName() const;
@@ -92,19 +92,27 @@ public:
 	QString getValue(ushort key) const {
 		Expects(key < _values.size());
 
+		if (_pendingCount.load(std::memory_order_acquire) > 0) {
+			parsePendingValue(key);
+		}
 		return _values[key];
 	}
 	QString getNonDefaultValue(const QByteArray &key) const;
 	bool isNonDefaultPlural(ushort key) const {
 		Expects(key + 5 < _nonDefaultSet.size());
 
-		return _nonDefaultSet[key]
-			|| _nonDefaultSet[key + 1]
-			|| _nonDefaultSet[key + 2]
-			|| _nonDefaultSet[key + 3]
-			|| _nonDefaultSet[key + 4]
-			|| _nonDefaultSet[key + 5]
-			|| (_base && _base->isNonDefaultPlural(key));
+		if (_pendingCount.load(std::memory_order_acquire) > 0) {
+			// Values that fail to parse are not counted as set.
+			for (auto i = 0; i != 6; ++i) {
+				parsePendingValue(ushort(key + i));
+			}
+		}
+		return isNonDefaultValue(key)
+			|| isNonDefaultValue(key + 1)
+			|| isNonDefaultValue(key + 2)
+			|| isNonDefaultValue(key + 3)
+			|| isNonDefaultValue(key + 4)
+			|| isNonDefaultValue(key + 5);
 	}
 
 private:
@@ -127,6 +135,24 @@ private:
 	void updatePluralRules();
 	void updateChoosingStickerReplacement();
 
+	[[nodiscard]] bool isNonDefaultValue(int index) const {
+		return !_failedValues[index]
+			&& (_nonDefaultSet[index]
+				|| (_base && _base->_nonDefaultSet[index]));
+	}
+	void setPendingValue(
+		ushort index,
+		const QByteArray &key,
+		const QByteArray &value,
+		const QByteArray &fallback);
+	void setPendingFallback(
+		ushort index,
+		const QByteArray &key,
+		const QByteArray &fallback);
+	void dropPendingValue(ushort index);
+	void parsePendingValue(ushort index) const;
+	void parsePendingValues() const;
+
 	Instance *_derived = nullptr;
 
 	QString _id, _pluralId;
@@ -146,7 +172,20 @@ private:
 
 	mutable QString _systemLanguage;
 
-	std::vector<QString> _values;
+	// Non-default values are parsed on first access, most of them
+	// are never shown in a session. Parsing may happen on any thread,
+	// so it uses only the pending value itself and writes only
+	// _values and _failedValues, all under _pendingMutex.
+	struct PendingValue {
+		QByteArray key;
+		QByteArray value;
+		QByteArray fallback; // Base language pack value, if any.
+	};
+	mutable std::vector<QString> _values;
+	mutable std::vector<PendingValue> _pendingValues;
+	mutable std::atomic<int> _pendingCount = 0;
+	mutable QMutex _pendingMutex;
+	mutable std::vector<uchar> _failedValues;
 	std::vector<uchar> _nonDefaultSet;
 	std::map<QByteArray, QByteArray> _nonDefaultValues;
 
@@ -216,6 +216,9 @@ bool FFMpegReaderImplementation::renderFrame(QImage &to, bool &hasAlpha, const Q
 	if (!size.isEmpty() && rotationSwapWidthHeight()) {
 		toSize.transpose();
 	}
+	_codecContext->skip_loop_filter = FFmpeg::SkipLoopFilterFor(
+		QSize(_width, _height),
+		size);
 	if (to.isNull() || to.size() != toSize || !to.isDetached() || !isAlignedImage(to)) {
 		to = createAlignedImage(toSize);
 	}
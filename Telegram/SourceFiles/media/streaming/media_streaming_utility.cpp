@@ -17,6 +17,30 @@ namespace {
 
 constexpr auto kSkipInvalidDataPackets = 10;
 
+using RangeTable = std::array<uint8_t, 256>;
+
+[[nodiscard]] RangeTable MakeLimitedRangeTable(int from, int till) {
+	auto result = RangeTable();
+	for (auto i = 0; i != 256; ++i) {
+		result[i] = uint8_t(from + (i * (till - from) + 127) / 255);
+	}
+	return result;
+}
+
+void SqueezePlane(
+		const uint8_t *from,
+		int stride,
+		QSize size,
+		uint8_t *to,
+		const RangeTable &table) {
+	for (auto y = 0; y != size.height(); ++y) {
+		for (auto x = 0; x != size.width(); ++x) {
+			*to++ = table[from[x]];
+		}
+		from += stride;
+	}
+}
+
 } // namespace
 
 crl::time FramePosition(const Stream &stream) {
@@ -196,6 +220,52 @@ FrameYUV420 ExtractYUV420(Stream &stream, AVFrame *frame) {
 	};
 }
 
+bool IsPlanarYUV420(not_null<AVFrame*> frame) {
+	return (frame->format == AV_PIX_FMT_YUV420P)
+		|| (frame->format == AV_PIX_FMT_YUVJ420P);
+}
+
+FrameYUV420 ExtractLimitedYUV420(
+		Stream &stream,
+		AVFrame *frame,
+		std::vector<uint8_t> &storage) {
+	if (frame->format != AV_PIX_FMT_YUVJ420P) {
+		return ExtractYUV420(stream, frame);
+	}
+	static const auto luma = MakeLimitedRangeTable(16, 235);
+	static const auto chroma = MakeLimitedRangeTable(16, 240);
+
+	const auto result = ExtractYUV420(stream, frame);
+	const auto lumaBytes = result.size.width() * result.size.height();
+	const auto chromaBytes = result.chromaSize.width()
+		* result.chromaSize.height();
+	storage.resize(lumaBytes + 2 * chromaBytes);
+
+	const auto y = storage.data();
+	const auto u = y + lumaBytes;
+	const auto v = u + chromaBytes;
+	SqueezePlane(frame->data[0], frame->linesize[0], result.size, y, luma);
+	SqueezePlane(
+		frame->data[1],
+		frame->linesize[1],
+		result.chromaSize,
+		u,
+		chroma);
+	SqueezePlane(
+		frame->data[2],
+		frame->linesize[2],
+		result.chromaSize,
+		v,
+		chroma);
+	return {
+		.size = result.size,
+		.chromaSize = result.chromaSize,
+		.y = { .data = y, .stride = result.size.width() },
+		.u = { .data = u, .stride = result.chromaSize.width() },
+		.v = { .data = v, .stride = result.chromaSize.width() },
+	};
+}
+
 void PaintFrameOuter(QPainter &p, const QRect &inner, QSize outer) {
 	const auto left = inner.x();
 	const auto right = outer.width() - inner.width() - left;
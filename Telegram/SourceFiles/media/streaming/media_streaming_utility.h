@@ -60,6 +60,14 @@ struct Stream {
 	QSize resize,
 	QImage storage);
 [[nodiscard]] FrameYUV420 ExtractYUV420(Stream &stream, AVFrame *frame);
+[[nodiscard]] bool IsPlanarYUV420(not_null<AVFrame*> frame);
+
+// Full range (JPEG) frames are squeezed to the limited range planes
+// in the storage, so they may be uploaded and converted the same way.
+[[nodiscard]] FrameYUV420 ExtractLimitedYUV420(
+	Stream &stream,
+	AVFrame *frame,
+	std::vector<uint8_t> &storage);
 [[nodiscard]] QImage PrepareByRequest(
 	const QImage &original,
 	bool alpha,
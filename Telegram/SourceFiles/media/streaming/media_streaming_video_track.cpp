@@ -129,6 +129,7 @@ private:
 	[[nodiscard]] FrameResult readFrame(not_null<Frame*> frame);
 	void fillRequests(not_null<Frame*> frame) const;
 	[[nodiscard]] QSize chooseOriginalResize() const;
+	void updateDecodeQuality();
 	void presentFrameIfNeeded();
 	void callReady();
 	[[nodiscard]] bool loopAround();
@@ -427,9 +428,12 @@ void VideoTrackObject::rasterizeFrame(not_null<Frame*> frame) {
 
 	fillRequests(frame);
 	frame->format = FrameFormat::None;
-	if (frame->decoded->format == AV_PIX_FMT_YUV420P && !requireARGB32()) {
+	if (IsPlanarYUV420(frame->decoded.get()) && !requireARGB32()) {
 		frame->alpha = false;
-		frame->yuv420 = ExtractYUV420(_stream, frame->decoded.get());
+		frame->yuv420 = ExtractLimitedYUV420(
+			_stream,
+			frame->decoded.get(),
+			frame->limitedRange);
 		if (frame->yuv420.size.isEmpty()
 			|| frame->yuv420.chromaSize.isEmpty()
 			|| !frame->yuv420.y.data
@@ -570,10 +574,20 @@ void VideoTrackObject::updateFrameRequest(
 		const Instance *instance,
 		const FrameRequest &request) {
 	_requests[instance] = request;
+	updateDecodeQuality();
 }
 
 void VideoTrackObject::removeFrameRequest(const Instance *instance) {
 	_requests.remove(instance);
+	updateDecodeQuality();
+}
+
+void VideoTrackObject::updateDecodeQuality() {
+	if (const auto codec = _stream.codec.get()) {
+		codec->skip_loop_filter = FFmpeg::SkipLoopFilterFor(
+			QSize(codec->width, codec->height),
+			chooseOriginalResize());
+	}
 }
 
 bool VideoTrackObject::tryReadFirstFrame(FFmpeg::Packet &&packet) {
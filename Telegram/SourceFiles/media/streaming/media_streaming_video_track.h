@@ -84,6 +84,7 @@ private:
 		FFmpeg::FramePointer decoded = FFmpeg::MakeFramePointer();
 		QImage original;
 		FrameYUV420 yuv420;
+		std::vector<uint8_t> limitedRange;
 		crl::time position = kTimeUnknown;
 		crl::time displayed = kTimeUnknown;
 		crl::time display = kTimeUnknown;
@@ -37,6 +37,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/view/media_view_playback_controls.h"
 #include "media/view/media_view_group_thumbs.h"
 #include "media/view/media_view_pip.h"
+#include "media/view/media_view_video_thumbnails.h"
 #include "media/view/media_view_overlay_raster.h"
 #include "media/view/media_view_overlay_opengl.h"
 #include "media/streaming/media_streaming_instance.h"
@@ -100,6 +101,7 @@ constexpr auto kMaxZoomLevel = 7; // x8
 constexpr auto kZoomToScreenLevel = 1024;
 constexpr auto kOverlayLoaderPriority = 2;
 constexpr auto kSeekTimeMs = 5 * crl::time(1000);
+constexpr auto kMaxCachedSeekThumbnails = 2;
 
 // macOS OpenGL renderer fails to render larger texture
 // even though it reports that max texture size is 16384.
@@ -236,6 +238,11 @@ struct OverlayWidget::Streamed {
 	bool resumeOnCallEnd = false;
 };
 
+struct OverlayWidget::SeekThumbnails {
+	not_null<DocumentData*> document;
+	std::shared_ptr<VideoThumbnails> thumbnails;
+};
+
 struct OverlayWidget::PipWrap {
 	PipWrap(
 		QWidget *parent,
@@ -691,6 +698,9 @@ void OverlayWidget::documentUpdated(DocumentData *doc) {
 				? std::clamp(_document->loadOffset(), 0, _document->size)
 				: 0;
 			_streamed->controls.setLoadingProgress(ready, _document->size);
+			if (_documentMedia->loaded()) {
+				refreshSeekThumbnails();
+			}
 		}
 	}
 }
@@ -1359,6 +1369,7 @@ void OverlayWidget::clearSession() {
 	_sharedMedia = nullptr;
 	_userPhotos = nullptr;
 	_collage = nullptr;
+	_seekThumbnails.clear();
 	_session = nullptr;
 }
 
@@ -2791,9 +2802,47 @@ bool OverlayWidget::createStreamingObjects() {
 		refreshClipControllerGeometry();
 		_streamed->controls.show();
 	// }
+	refreshSeekThumbnails();
 	return true;
 }
 
+void OverlayWidget::refreshSeekThumbnails() {
+	if (!_streamed || !_document || !_document->isVideoFile()) {
+		return;
+	}
+	_streamed->controls.setSeekThumbnails(lookupSeekThumbnails());
+}
+
+std::shared_ptr<VideoThumbnails> OverlayWidget::lookupSeekThumbnails() {
+	Expects(_document != nullptr);
+
+	const auto i = ranges::find(
+		_seekThumbnails,
+		not_null{ _document },
+		&SeekThumbnails::document);
+	if (i != end(_seekThumbnails)) {
+		auto result = i->thumbnails;
+		std::rotate(i, i + 1, end(_seekThumbnails));
+		return result;
+	}
+
+	// Only a local copy is decoded, previews never cause any downloads.
+	const auto bytes = _documentMedia->bytes();
+	const auto path = bytes.isEmpty() ? _document->filepath(true) : QString();
+	if (bytes.isEmpty() && path.isEmpty()) {
+		return nullptr;
+	}
+	if (int(_seekThumbnails.size()) >= kMaxCachedSeekThumbnails) {
+		_seekThumbnails.erase(begin(_seekThumbnails));
+	}
+	auto result = std::make_shared<VideoThumbnails>(
+		path,
+		bytes,
+		st::mediaviewSeekPreviewWidth * style::DevicePixelRatio());
+	_seekThumbnails.push_back({ _document, result });
+	return result;
+}
+
 void OverlayWidget::updatePowerSaveBlocker(
 		const Player::TrackState &state) {
 	Expects(_streamed != nullptr);
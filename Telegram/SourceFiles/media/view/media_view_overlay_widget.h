@@ -57,6 +57,7 @@ namespace Media::View {
 
 class GroupThumbs;
 class Pip;
+class VideoThumbnails;
 
 class OverlayWidget final
 	: public ClickHandlerHost
@@ -105,6 +106,7 @@ public:
 private:
 	struct Streamed;
 	struct PipWrap;
+	struct SeekThumbnails;
 	class Renderer;
 	class RendererSW;
 	class RendererGL;
@@ -302,6 +304,8 @@ private:
 
 	void refreshClipControllerGeometry();
 	void refreshCaptionGeometry();
+	void refreshSeekThumbnails();
+	[[nodiscard]] std::shared_ptr<VideoThumbnails> lookupSeekThumbnails();
 
 	bool initStreaming(bool continueStreaming = false);
 	void startStreamingPlayer();
@@ -488,6 +492,7 @@ private:
 	std::unique_ptr<Streamed> _streamed;
 	std::unique_ptr<PipWrap> _pip;
 	int _streamedCreated = 0;
+	std::vector<SeekThumbnails> _seekThumbnails; // Recently used last.
 	bool _showAsPip = false;
 
 	const style::icon *_docIcon = nullptr;
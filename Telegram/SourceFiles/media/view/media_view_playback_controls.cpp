@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "media/audio/media_audio.h"
 #include "media/view/media_view_playback_progress.h"
+#include "media/view/media_view_video_thumbnails.h"
 #include "ui/widgets/labels.h"
 #include "ui/widgets/continuous_sliders.h"
 #include "ui/effects/fade_animation.h"
@@ -18,6 +19,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/text/format_values.h"
 #include "ui/cached_round_corners.h"
 #include "lang/lang_keys.h"
+#include "base/event_filter.h"
 #include "styles/style_media_view.h"
 
 namespace Media {
@@ -278,6 +280,123 @@ PlaybackControls::PlaybackControls(
 		_playbackProgress->setValue(value, false);
 		handleSeekFinished(value);
 	});
+	setupSeekPreview();
+}
+
+void PlaybackControls::setupSeekPreview() {
+	_playbackSlider->setMouseTracking(true);
+	base::install_event_filter(_playbackSlider.data(), [=](
+			not_null<QEvent*> e) {
+		const auto type = e->type();
+		if (type == QEvent::MouseMove) {
+			const auto x = static_cast<QMouseEvent*>(e.get())->pos().x();
+			const auto width = _playbackSlider->width();
+			if (width > 0) {
+				showSeekPreview(std::clamp(x / float64(width), 0., 1.));
+			}
+		} else if (type == QEvent::Leave && _seekPositionMs < 0) {
+			hideSeekPreview();
+		}
+		return base::EventFilterResult::Continue;
+	});
+}
+
+void PlaybackControls::setSeekThumbnails(
+		std::shared_ptr<VideoThumbnails> thumbnails) {
+	if (_seekThumbnails == thumbnails) {
+		return;
+	}
+	_seekThumbnailsLifetime.destroy();
+	_seekThumbnails = std::move(thumbnails);
+	if (!_seekThumbnails) {
+		hideSeekPreview();
+		return;
+	}
+	_seekThumbnails->updates(
+	) | rpl::start_with_next([=] {
+		if (_seekPreviewProgress >= 0.) {
+			showSeekPreview(_seekPreviewProgress);
+		}
+	}, _seekThumbnailsLifetime);
+}
+
+void PlaybackControls::showSeekPreview(float64 progress) {
+	if (!_seekThumbnails || _seekThumbnails->empty() || !_lastDurationMs) {
+		hideSeekPreview();
+		return;
+	}
+	_seekPreviewProgress = progress;
+	_seekPreviewImage = _seekThumbnails->lookup(
+		static_cast<crl::time>(progress * _lastDurationMs));
+	if (!_seekPreview) {
+		_seekPreview = base::make_unique_q<Ui::RpWidget>(parentWidget());
+		_seekPreview->setAttribute(Qt::WA_TransparentForMouseEvents);
+		_seekPreview->paintRequest(
+		) | rpl::start_with_next([=] {
+			Painter p(_seekPreview.get());
+			paintSeekPreview(p);
+		}, _seekPreview->lifetime());
+	}
+	updateSeekPreviewGeometry();
+	_seekPreview->show();
+	_seekPreview->raise();
+	_seekPreview->update();
+}
+
+void PlaybackControls::hideSeekPreview() {
+	_seekPreviewProgress = -1.;
+	_seekPreviewImage = QImage();
+	_seekPreview = nullptr;
+}
+
+void PlaybackControls::updateSeekPreviewGeometry() {
+	const auto &padding = st::mediaviewSeekPreviewPadding;
+	const auto image = _seekPreviewImage.size()
+		/ style::DevicePixelRatio();
+	const auto font = st::mediaviewPlayProgressLabel.font;
+	const auto size = QSize(
+		padding.left() + image.width() + padding.right(),
+		padding.top() + image.height() + font->height + padding.bottom());
+	const auto slider = _playbackSlider->geometry();
+	const auto center = x()
+		+ slider.x()
+		+ int(base::SafeRound(_seekPreviewProgress * slider.width()));
+	const auto available = parentWidget()->width() - size.width();
+	const auto left = std::clamp(
+		center - size.width() / 2,
+		0,
+		std::max(available, 0));
+	const auto top = y() - st::mediaviewSeekPreviewSkip - size.height();
+	_seekPreview->setGeometry(QRect(QPoint(left, top), size));
+}
+
+void PlaybackControls::paintSeekPreview(Painter &p) {
+	const auto radius = st::mediaviewSeekPreviewRadius;
+	{
+		PainterHighQualityEnabler hq(p);
+		p.setPen(Qt::NoPen);
+		p.setBrush(st::mediaviewSaveMsgBg);
+		p.drawRoundedRect(_seekPreview->rect(), radius, radius);
+	}
+	const auto &padding = st::mediaviewSeekPreviewPadding;
+	const auto image = QRect(
+		QPoint(padding.left(), padding.top()),
+		_seekPreviewImage.size() / style::DevicePixelRatio());
+	p.drawImage(image, _seekPreviewImage);
+
+	const auto &st = st::mediaviewPlayProgressLabel;
+	const auto position = static_cast<crl::time>(
+		_seekPreviewProgress * _lastDurationMs);
+	p.setPen(st.textFg);
+	p.setFont(st.font);
+	p.drawText(
+		QRect(
+			image.x(),
+			image.y() + image.height(),
+			image.width(),
+			st.font->height),
+		Ui::FormatDurationText(position / crl::time(1000)),
+		style::al_center);
 }
 
 void PlaybackControls::handleSeekProgress(float64 progress) {
@@ -304,6 +423,9 @@ void PlaybackControls::handleSeekFinished(float64 progress) {
 		crl::time(0),
 		_lastDurationMs);
 	_seekPositionMs = -1;
+	if (!_playbackSlider->underMouse()) {
+		hideSeekPreview();
+	}
 	_delegate->playbackControlsSeekFinished(positionMs);
 	refreshTimeTexts();
 }
@@ -340,6 +462,7 @@ void PlaybackControls::showAnimated() {
 }
 
 void PlaybackControls::hideAnimated() {
+	hideSeekPreview();
 	startFading([this]() {
 		_fadeAnimation->fadeOut(st::mediaviewHideDuration);
 	});
@@ -12,6 +12,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/unique_qptr.h"
 #include "styles/style_widgets.h"
 
+class Painter;
+
 namespace Ui {
 class LabelSimple;
 class FadeAnimation;
@@ -28,6 +30,7 @@ struct TrackState;
 namespace View {
 
 class PlaybackProgress;
+class VideoThumbnails;
 
 class PlaybackControls : public Ui::RpWidget {
 public:
@@ -57,6 +60,7 @@ public:
 	void updatePlayback(const Player::TrackState &state);
 	void setLoadingProgress(int ready, int total);
 	void setInFullScreen(bool inFullScreen);
+	void setSeekThumbnails(std::shared_ptr<VideoThumbnails> thumbnails);
 	[[nodiscard]] bool hasMenu() const;
 
 	~PlaybackControls();
@@ -87,6 +91,12 @@ private:
 	void refreshTimeTexts();
 	void showMenu();
 
+	void setupSeekPreview();
+	void showSeekPreview(float64 progress);
+	void hideSeekPreview();
+	void updateSeekPreviewGeometry();
+	void paintSeekPreview(Painter &p);
+
 	not_null<Delegate*> _delegate;
 
 	bool _inFullScreen = false;
@@ -112,6 +122,12 @@ private:
 	object_ptr<Ui::LabelSimple> _toPlayLeft;
 	object_ptr<Ui::LabelSimple> _downloadProgress = { nullptr };
 
+	std::shared_ptr<VideoThumbnails> _seekThumbnails;
+	base::unique_qptr<Ui::RpWidget> _seekPreview;
+	float64 _seekPreviewProgress = -1.;
+	QImage _seekPreviewImage;
+	rpl::lifetime _seekThumbnailsLifetime;
+
 	const style::PopupMenu &_menuStyle;
 	base::unique_qptr<Ui::PopupMenu> _menu;
 	std::unique_ptr<Ui::FadeAnimation> _fadeAnimation;
@@ -0,0 +1,336 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "media/view/media_view_video_thumbnails.h"
+
+#include "media/streaming/media_streaming_utility.h"
+#include "ffmpeg/ffmpeg_utility.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QFile>
+
+namespace Media {
+namespace View {
+namespace {
+
+constexpr auto kMaxThumbnails = 40;
+constexpr auto kMinInterval = crl::time(2000);
+constexpr auto kMaxPacketsPerKeyframe = 64;
+
+// Coarse thumbnails are generated first, so that the whole timeline
+// gets some previews quickly, the gaps are filled in afterwards.
+constexpr auto kFirstPassStride = 8;
+
+class Generator final {
+public:
+	Generator(QString path, QByteArray bytes, int width);
+
+	void generate(
+		const std::atomic<bool> &cancelled,
+		Fn<void(crl::time, QImage)> done);
+
+private:
+	[[nodiscard]] bool open();
+	[[nodiscard]] std::optional<crl::time> seek(crl::time position);
+	[[nodiscard]] QImage readKeyframe();
+	[[nodiscard]] QImage prepare();
+
+	static int Read(void *opaque, uint8_t *buffer, int bufferSize);
+	static int64_t Seek(void *opaque, int64_t offset, int whence);
+
+	const QString _path;
+	QByteArray _bytes;
+	const int _width = 0;
+
+	QFile _file;
+	QBuffer _buffer;
+	QIODevice *_device = nullptr;
+	FFmpeg::FormatPointer _format;
+	Streaming::Stream _stream;
+	base::flat_set<crl::time> _found;
+
+};
+
+Generator::Generator(QString path, QByteArray bytes, int width)
+: _path(path)
+, _bytes(bytes)
+, _width(width) {
+}
+
+int Generator::Read(void *opaque, uint8_t *buffer, int bufferSize) {
+	const auto that = static_cast<Generator*>(opaque);
+	const auto result = int(that->_device->read(
+		reinterpret_cast<char*>(buffer),
+		bufferSize));
+	return result ? result : AVERROR_EOF;
+}
+
+int64_t Generator::Seek(void *opaque, int64_t offset, int whence) {
+	const auto that = static_cast<Generator*>(opaque);
+	const auto device = that->_device;
+
+	switch (whence) {
+	case SEEK_SET: return device->seek(offset) ? device->pos() : -1;
+	case SEEK_CUR: return device->seek(device->pos() + offset)
+		? device->pos()
+		: -1;
+	case SEEK_END: return device->seek(device->size() + offset)
+		? device->pos()
+		: -1;
+	case AVSEEK_SIZE: return device->size();
+	}
+	return -1;
+}
+
+bool Generator::open() {
+	if (!_bytes.isEmpty()) {
+		_buffer.setData(_bytes);
+		_device = &_buffer;
+	} else {
+		_file.setFileName(_path);
+		_device = &_file;
+	}
+	if (!_device->open(QIODevice::ReadOnly)) {
+		return false;
+	}
+	_format = FFmpeg::MakeFormatPointer(
+		static_cast<void*>(this),
+		&Generator::Read,
+		nullptr,
+		&Generator::Seek);
+	if (!_format) {
+		return false;
+	}
+	auto error = FFmpeg::AvErrorWrap(
+		avformat_find_stream_info(_format.get(), nullptr));
+	if (error) {
+		FFmpeg::LogError(qstr("avformat_find_stream_info"), error);
+		return false;
+	}
+	const auto index = av_find_best_stream(
+		_format.get(),
+		AVMEDIA_TYPE_VIDEO,
+		-1,
+		-1,
+		nullptr,
+		0);
+	if (index < 0) {
+		return false;
+	}
+	const auto info = _format->streams[index];
+	if (info->disposition & AV_DISPOSITION_ATTACHED_PIC) {
+		return false;
+	}
+	_stream.index = index;
+	_stream.timeBase = info->time_base;
+	_stream.duration = (info->duration != AV_NOPTS_VALUE)
+		? FFmpeg::PtsToTime(info->duration, _stream.timeBase)
+		: (_format->duration != AV_NOPTS_VALUE)
+		? FFmpeg::PtsToTime(_format->duration, FFmpeg::kUniversalTimeBase)
+		: 0;
+	if (_stream.duration <= 0) {
+		return false;
+	}
+	_stream.rotation = FFmpeg::ReadRotationFromMetadata(info);
+	_stream.aspect = FFmpeg::ValidateAspectRatio(info->sample_aspect_ratio);
+	_stream.codec = FFmpeg::MakeCodecPointer(info);
+	if (!_stream.codec) {
+		return false;
+	}
+
+	// Only keyframes are decoded and they are shown tiny anyway.
+	_stream.codec->skip_frame = AVDISCARD_NONKEY;
+	_stream.codec->skip_loop_filter = AVDISCARD_ALL;
+
+	_stream.frame = FFmpeg::MakeFramePointer();
+	return (_stream.frame != nullptr);
+}
+
+std::optional<crl::time> Generator::seek(crl::time position) {
+	auto error = FFmpeg::AvErrorWrap(av_seek_frame(
+		_format.get(),
+		_stream.index,
+		FFmpeg::TimeToPts(position, _stream.timeBase),
+		AVSEEK_FLAG_BACKWARD));
+	if (error) {
+		return std::nullopt;
+	}
+	avcodec_flush_buffers(_stream.codec.get());
+	_stream.queue.clear();
+
+	// Peek at the first packet, it is the keyframe we've landed on.
+	auto packet = FFmpeg::Packet();
+	while (true) {
+		error = av_read_frame(_format.get(), &packet.fields());
+		if (error) {
+			return std::nullopt;
+		} else if (packet.fields().stream_index == _stream.index) {
+			break;
+		}
+		packet = FFmpeg::Packet();
+	}
+	const auto result = FFmpeg::PacketPosition(packet, _stream.timeBase);
+	_stream.queue.push_back(std::move(packet));
+	return result;
+}
+
+QImage Generator::readKeyframe() {
+	auto error = FFmpeg::AvErrorWrap();
+	auto drained = false;
+	for (auto packets = 0; packets != kMaxPacketsPerKeyframe;) {
+		error = Streaming::ReadNextFrame(_stream);
+		if (!error) {
+			return prepare();
+		} else if (error.code() != AVERROR(EAGAIN) || drained) {
+			return QImage();
+		}
+		auto packet = FFmpeg::Packet();
+		error = av_read_frame(_format.get(), &packet.fields());
+		if (error) {
+			if (error.code() != AVERROR_EOF) {
+				return QImage();
+			}
+			drained = true;
+			if (Streaming::ProcessPacket(_stream, FFmpeg::Packet())) {
+				return QImage();
+			}
+		} else if (packet.fields().stream_index == _stream.index) {
+			++packets;
+			if (Streaming::ProcessPacket(_stream, std::move(packet))) {
+				return QImage();
+			}
+		}
+	}
+	return QImage();
+}
+
+QImage Generator::prepare() {
+	const auto frame = _stream.frame.get();
+	auto size = FFmpeg::CorrectByAspect(
+		QSize(frame->width, frame->height),
+		_stream.aspect);
+	if (FFmpeg::RotationSwapWidthHeight(_stream.rotation)) {
+		size.transpose();
+	}
+	if (size.isEmpty()) {
+		return QImage();
+	}
+	const auto resize = QSize(
+		_width,
+		std::max(_width * size.height() / size.width(), 1));
+	auto result = Streaming::ConvertFrame(
+		_stream,
+		frame,
+		resize,
+		QImage());
+	if (!result.isNull() && _stream.rotation) {
+		result = result.transformed(QTransform().rotate(_stream.rotation));
+	}
+	return result;
+}
+
+void Generator::generate(
+		const std::atomic<bool> &cancelled,
+		Fn<void(crl::time, QImage)> done) {
+	if (!open()) {
+		return;
+	}
+	const auto count = int(std::clamp(
+		_stream.duration / kMinInterval,
+		crl::time(1),
+		crl::time(kMaxThumbnails)));
+	const auto interval = _stream.duration / count;
+
+	auto order = std::vector<int>();
+	order.reserve(count);
+	for (auto stride = kFirstPassStride; stride != 0; stride /= 2) {
+		for (auto i = 0; i < count; i += stride) {
+			if (!(i % (stride * 2)) && stride != kFirstPassStride) {
+				continue;
+			}
+			order.push_back(i);
+		}
+	}
+	for (const auto index : order) {
+		if (cancelled) {
+			return;
+		}
+		const auto keyframe = seek(index * interval);
+		if (!keyframe) {
+			return;
+		} else if (!_found.emplace(*keyframe).second) {
+			// Long GOP, this keyframe was already decoded.
+			continue;
+		}
+		auto image = readKeyframe();
+		if (image.isNull()) {
+			continue;
+		}
+		done(*keyframe, std::move(image));
+	}
+}
+
+} // namespace
+
+VideoThumbnails::VideoThumbnails(QString path, QByteArray bytes, int width)
+: _cancelled(std::make_shared<std::atomic<bool>>(false)) {
+	Expects(width > 0);
+
+	crl::async([=, cancelled = _cancelled, weak = base::make_weak(this)] {
+		auto generator = Generator(path, bytes, width);
+		generator.generate(*cancelled, [=](crl::time position, QImage image) {
+			crl::on_main(weak, [=, image = std::move(image)]() mutable {
+				push(position, std::move(image));
+			});
+		});
+	});
+}
+
+VideoThumbnails::~VideoThumbnails() {
+	*_cancelled = true;
+}
+
+void VideoThumbnails::push(crl::time position, QImage image) {
+	const auto i = ranges::lower_bound(
+		_thumbnails,
+		position,
+		ranges::less(),
+		&Thumbnail::position);
+	_thumbnails.insert(i, { position, std::move(image) });
+	_updates.fire({});
+}
+
+QImage VideoThumbnails::lookup(crl::time position) const {
+	if (_thumbnails.empty()) {
+		return QImage();
+	}
+	const auto i = ranges::lower_bound(
+		_thumbnails,
+		position,
+		ranges::less(),
+		&Thumbnail::position);
+	if (i == begin(_thumbnails)) {
+		return i->image;
+	} else if (i == end(_thumbnails)) {
+		return _thumbnails.back().image;
+	}
+	const auto before = i - 1;
+	return (position - before->position < i->position - position)
+		? before->image
+		: i->image;
+}
+
+bool VideoThumbnails::empty() const {
+	return _thumbnails.empty();
+}
+
+rpl::producer<> VideoThumbnails::updates() const {
+	return _updates.events();
+}
+
+} // namespace View
+} // namespace Media
@@ -0,0 +1,42 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+namespace Media {
+namespace View {
+
+// Low resolution keyframes along the video timeline, shown as previews
+// when hovering the seek bar. Only a fully available local copy of the
+// file is decoded, so generating them never costs any network traffic.
+class VideoThumbnails final : public base::has_weak_ptr {
+public:
+	VideoThumbnails(QString path, QByteArray bytes, int width);
+	~VideoThumbnails();
+
+	[[nodiscard]] QImage lookup(crl::time position) const;
+	[[nodiscard]] bool empty() const;
+	[[nodiscard]] rpl::producer<> updates() const;
+
+private:
+	struct Thumbnail {
+		crl::time position = 0;
+		QImage image;
+	};
+
+	void push(crl::time position, QImage image);
+
+	const std::shared_ptr<std::atomic<bool>> _cancelled;
+	std::vector<Thumbnail> _thumbnails;
+	rpl::event_stream<> _updates;
+
+};
+
+} // namespace View
+} // namespace Media
@@ -0,0 +1,112 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "mtproto/details/mtproto_packet_decryptor.h"
+
+#include "base/openssl_help.h"
+
+#include <QtCore/QSemaphore>
+
+namespace MTP::details {
+namespace {
+
+constexpr auto kIntSize = static_cast<int>(sizeof(mtpPrime));
+constexpr auto kExternalHeaderIntsCount = 6U; // 2 auth_key_id, 4 msg_key
+constexpr auto kMsgKeyShift = 8U;
+
+// Smaller packets are cheaper to decrypt than to pass to another thread.
+constexpr auto kParallelMinBytes = 64 * 1024;
+
+void DecryptOne(
+		const mtpBuffer &packet,
+		const AuthKeyPtr &key,
+		DecryptedPacket &result) {
+	const auto ints = packet.constData();
+	const auto intsCount = uint32(packet.size());
+	const auto encryptedInts = ints + kExternalHeaderIntsCount;
+	const auto encryptedIntsCount = (intsCount - kExternalHeaderIntsCount)
+		& ~0x03U;
+	const auto encryptedBytesCount = encryptedIntsCount * kIntSize;
+	const auto msgKey = *(MTPint128*)(ints + 2);
+
+	result.encryptedBytesCount = encryptedBytesCount;
+	result.data = QByteArray(encryptedBytesCount, Qt::Uninitialized);
+	aesIgeDecrypt(
+		encryptedInts,
+		result.data.data(),
+		encryptedBytesCount,
+		key,
+		msgKey);
+
+	std::array<uchar, 32> sha256Buffer = { { 0 } };
+
+	SHA256_CTX msgKeyLargeContext;
+	SHA256_Init(&msgKeyLargeContext);
+	SHA256_Update(&msgKeyLargeContext, key->partForMsgKey(false), 32);
+	SHA256_Update(
+		&msgKeyLargeContext,
+		result.data.constData(),
+		encryptedBytesCount);
+	SHA256_Final(sha256Buffer.data(), &msgKeyLargeContext);
+
+	result.verified = !ConstTimeIsDifferent(
+		&msgKey,
+		sha256Buffer.data() + kMsgKeyShift,
+		sizeof(msgKey));
+}
+
+} // namespace
+
+std::vector<DecryptedPacket> DecryptPackets(
+		const std::vector<mtpBuffer> &packets,
+		const AuthKeyPtr &key) {
+	auto result = std::vector<DecryptedPacket>(packets.size());
+	if (packets.empty()) {
+		return result;
+	}
+
+	auto semaphore = QSemaphore();
+	auto scheduled = 0;
+	const auto count = int(packets.size());
+
+	// Keep the first packet for the current thread, it is needed first.
+	for (auto i = 1; i != count; ++i) {
+		if (packets[i].size() * kIntSize < kParallelMinBytes) {
+			continue;
+		}
+		const auto packet = &packets[i];
+		const auto decrypted = &result[i];
+		crl::async([=, &semaphore] {
+			DecryptOne(*packet, key, *decrypted);
+			semaphore.release();
+		});
+		++scheduled;
+	}
+	for (auto i = 0; i != count; ++i) {
+		if (i > 0 && packets[i].size() * kIntSize >= kParallelMinBytes) {
+			continue;
+		}
+		DecryptOne(packets[i], key, result[i]);
+	}
+	semaphore.acquire(scheduled);
+	return result;
+}
+
+bool ConstTimeIsDifferent(
+		const void *a,
+		const void *b,
+		size_t size) {
+	auto ca = reinterpret_cast<const char*>(a);
+	auto cb = reinterpret_cast<const char*>(b);
+	volatile auto different = false;
+	for (const auto ce = ca + size; ca != ce; ++ca, ++cb) {
+		different = different | (*ca != *cb);
+	}
+	return different;
+}
+
+} // namespace MTP::details
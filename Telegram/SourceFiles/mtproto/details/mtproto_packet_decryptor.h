@@ -0,0 +1,32 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "mtproto/mtproto_auth_key.h"
+
+namespace MTP::details {
+
+struct DecryptedPacket {
+	QByteArray data;
+	uint32 encryptedBytesCount = 0;
+	bool verified = false;
+};
+
+// Packets are expected to be already checked for length and auth_key_id.
+// Large packets are decrypted and checked on crl::async workers shared
+// by all sessions, results are returned in the order of the packets.
+[[nodiscard]] std::vector<DecryptedPacket> DecryptPackets(
+	const std::vector<mtpBuffer> &packets,
+	const AuthKeyPtr &key);
+
+[[nodiscard]] bool ConstTimeIsDifferent(
+	const void *a,
+	const void *b,
+	size_t size);
+
+} // namespace MTP::details
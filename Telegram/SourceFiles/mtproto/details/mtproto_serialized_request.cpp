@@ -46,8 +46,9 @@ SerializedRequest SerializedRequest::Prepare(
 
 	const auto finalSize = std::max(size, reserveSize);
 
+	// Reserve place for the padding, so that sending won't reallocate.
 	auto result = SerializedRequest(RequestConstructHider::Tag{});
-	result->reserve(kMessageBodyPosition + finalSize);
+	result->reserve(kMessageBodyPosition + finalSize + kMaxPaddingInts);
 	result->resize(kMessageBodyPosition);
 	result->back() = (size << 2);
 	result->lastSentTime = crl::now();
@@ -40,6 +40,9 @@ public:
 	static constexpr auto kMessageBodyPosition = kMessageLengthPosition
 		+ kMessageLengthInts;
 
+	// Random padding added by addPadding() never exceeds this.
+	static constexpr auto kMaxPaddingInts = 6 + 60;
+
 	static SerializedRequest Prepare(uint32 size, uint32 reserveSize = 0);
 
 	template <
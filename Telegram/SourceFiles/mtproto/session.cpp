@@ -16,6 +16,14 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace MTP {
 namespace details {
+namespace {
+
+// Small requests (typing, read receipts, etc) are delayed a bit,
+// so that bursts of them are sent in a single container.
+constexpr auto kSmallRequestMaxInts = 64;
+constexpr auto kSmallRequestCoalesceDelay = crl::time(4);
+
+} // namespace
 
 SessionOptions::SessionOptions(
 	const QString &systemLangCode,
@@ -431,8 +439,16 @@ void Session::sendPrepared(
 
 	DEBUG_LOG(("MTP Info: added, requestId %1").arg(request->requestId));
 	if (msCanWait >= 0) {
+		const auto small = !msCanWait
+			&& (request.messageSize() <= kSmallRequestMaxInts);
 		InvokeQueued(this, [=] {
-			sendAnything(msCanWait);
+			// Delaying is safe only when we're connected and the
+			// delay won't hold back a connection initialization.
+			const auto coalesce = small
+				&& _private
+				&& (_private->getState() == ConnectedState)
+				&& connectionInited();
+			sendAnything(coalesce ? kSmallRequestCoalesceDelay : msCanWait);
 		});
 	}
 }
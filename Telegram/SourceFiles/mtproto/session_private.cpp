@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/details/mtproto_bound_key_creator.h"
 #include "mtproto/details/mtproto_dcenter.h"
 #include "mtproto/details/mtproto_dump_to_text.h"
+#include "mtproto/details/mtproto_packet_decryptor.h"
 #include "mtproto/details/mtproto_rsa_public_key.h"
 #include "mtproto/session.h"
 #include "mtproto/mtproto_response.h"
@@ -61,6 +62,12 @@ constexpr auto kSendStateRequestWaiting = crl::time(1000);
 // How much time to wait for some more requests, when sending msg acks.
 constexpr auto kAckSendWaiting = 10 * crl::time(1000);
 
+// Server doesn't accept containers with more messages than this.
+constexpr auto kMaxContainerMessages = 1020;
+
+// Bigger batches are split in several containers.
+constexpr auto kMaxContainerInts = uint32(1024 * 1024 / kIntSize);
+
 auto SyncTimeRequestDuration = kFastRequestDuration;
 
 using namespace details;
@@ -128,19 +135,6 @@ void WrapInvokeAfter(
 	}
 }
 
-[[nodiscard]] bool ConstTimeIsDifferent(
-		const void *a,
-		const void *b,
-		size_t size) {
-	auto ca = reinterpret_cast<const char*>(a);
-	auto cb = reinterpret_cast<const char*>(b);
-	volatile auto different = false;
-	for (const auto ce = ca + size; ca != ce; ++ca, ++cb) {
-		different = different | (*ca != *cb);
-	}
-	return different;
-}
-
 } // namespace
 
 SessionPrivate::SessionPrivate(
@@ -702,6 +696,7 @@ void SessionPrivate::tryToSend() {
 	}
 
 	bool needAnyResponse = false;
+	bool hasMoreToSend = false;
 	SerializedRequest toSendRequest;
 	{
 		QWriteLocker locker1(_sessionData->toSendMutex());
@@ -716,13 +711,40 @@ void SessionPrivate::tryToSend() {
 			locker1.unlock();
 		}
 
-		uint32 toSendCount = toSend.size();
-		if (pingRequest) ++toSendCount;
-		if (ackRequest) ++toSendCount;
-		if (resendRequest) ++toSendCount;
-		if (stateRequest) ++toSendCount;
-		if (httpWaitRequest) ++toSendCount;
-		if (bindDcKeyRequest) ++toSendCount;
+		// Service messages (ping, acks, resends, state requests and so on)
+		// go into the same container, leave room for them.
+		const auto serviceCount = (pingRequest ? 1 : 0)
+			+ (ackRequest ? 1 : 0)
+			+ (resendRequest ? 1 : 0)
+			+ (stateRequest ? 1 : 0)
+			+ (httpWaitRequest ? 1 : 0)
+			+ (bindDcKeyRequest ? 1 : 0);
+
+		// Take as many requests as fit in one container,
+		// the rest will be sent right after this one.
+		auto toSendTake = 0;
+		auto toSendTakeSize = uint32(0);
+		for (const auto &[requestId, request] : toSend) {
+			const auto size = request.messageSize();
+			if (toSendTake > 0
+				&& (toSendTake + serviceCount >= kMaxContainerMessages
+					|| toSendTakeSize + size > kMaxContainerInts)) {
+				break;
+			}
+			++toSendTake;
+			toSendTakeSize += size;
+		}
+		const auto toSendTaken = [&] {
+			return ranges::make_subrange(
+				toSend.begin(),
+				toSend.begin() + toSendTake);
+		};
+		const auto eraseTaken = [&] {
+			toSend.erase(toSend.begin(), toSend.begin() + toSendTake);
+			hasMoreToSend = !toSend.empty();
+		};
+
+		const auto toSendCount = uint32(toSendTake + serviceCount);
 
 		if (!toSendCount) {
 			return; // nothing to send
@@ -744,7 +766,7 @@ void SessionPrivate::tryToSend() {
 		if (toSendCount == 1 && !first->forceSendInContainer) {
 			toSendRequest = first;
 			if (sendAll) {
-				toSend.clear();
+				eraseTaken();
 				locker1.unlock();
 			}
 
@@ -813,7 +835,7 @@ void SessionPrivate::tryToSend() {
 			if (stateRequest) containerSize += stateRequest.messageSize();
 			if (httpWaitRequest) containerSize += httpWaitRequest.messageSize();
 			if (bindDcKeyRequest) containerSize += bindDcKeyRequest.messageSize();
-			for (const auto &[requestId, request] : toSend) {
+			for (const auto &[requestId, request] : toSendTaken()) {
 				containerSize += request.messageSize();
 				if (needsLayer && request->needsLayer) {
 					containerSize += initSizeInInts;
@@ -830,7 +852,7 @@ void SessionPrivate::tryToSend() {
 			// prepare container + each in invoke after
 			toSendRequest = SerializedRequest::Prepare(
 				containerSize,
-				containerSize + 3 * toSend.size());
+				containerSize + 3 * toSendTake);
 			toSendRequest->push_back(mtpc_msg_container);
 			toSendRequest->push_back(toSendCount);
 
@@ -864,7 +886,7 @@ void SessionPrivate::tryToSend() {
 				needAnyResponse = true;
 			}
 
-			for (auto &[requestId, request] : toSend) {
+			for (auto &[requestId, request] : toSendTaken()) {
 				const auto msgId = prepareToSend(
 					request,
 					bigMsgId,
@@ -909,7 +931,7 @@ void SessionPrivate::tryToSend() {
 					memcpy(toSendRequest->data() + from, request->constData() + 4, len * sizeof(mtpPrime));
 				}
 			}
-			toSend.clear();
+			eraseTaken();
 
 			if (stateRequest) {
 				const auto msgId = placeToContainer(
@@ -956,6 +978,9 @@ void SessionPrivate::tryToSend() {
 		}
 	}
 	sendSecureRequest(std::move(toSendRequest), needAnyResponse);
+	if (hasMoreToSend) {
+		_sessionData->queueSendAnything();
+	}
 }
 
 void SessionPrivate::retryByTimer() {
@@ -1243,36 +1268,44 @@ void SessionPrivate::handleReceived() {
 
 	onReceivedSome();
 
-	while (!_connection->received().empty()) {
-		auto intsBuffer = std::move(_connection->received().front());
-		_connection->received().pop_front();
+	constexpr auto kExternalHeaderIntsCount = 6U; // 2 auth_key_id, 4 msg_key
+	constexpr auto kEncryptedHeaderIntsCount = 8U; // 2 salt, 2 session, 2 msg_id, 1 seq_no, 1 length
+	constexpr auto kMinimalEncryptedIntsCount = kEncryptedHeaderIntsCount + 4U; // + 1 data + 3 padding
+	constexpr auto kMinimalIntsCount = kExternalHeaderIntsCount + kMinimalEncryptedIntsCount;
+
+	// Take all the packets with good headers and decrypt them together,
+	// the first packet with a bad header restarts after the good ones.
+	auto packets = std::vector<mtpBuffer>();
+	auto badHeader = false;
+	auto &received = _connection->received();
+	packets.reserve(received.size());
+	while (!received.empty()) {
+		auto intsBuffer = std::move(received.front());
+		received.pop_front();
 
-		constexpr auto kExternalHeaderIntsCount = 6U; // 2 auth_key_id, 4 msg_key
-		constexpr auto kEncryptedHeaderIntsCount = 8U; // 2 salt, 2 session, 2 msg_id, 1 seq_no, 1 length
-		constexpr auto kMinimalEncryptedIntsCount = kEncryptedHeaderIntsCount + 4U; // + 1 data + 3 padding
-		constexpr auto kMinimalIntsCount = kExternalHeaderIntsCount + kMinimalEncryptedIntsCount;
 		auto intsCount = uint32(intsBuffer.size());
 		auto ints = intsBuffer.constData();
 		if ((intsCount < kMinimalIntsCount) || (intsCount > kMaxMessageLength / kIntSize)) {
 			LOG(("TCP Error: bad message received, len %1").arg(intsCount * kIntSize));
-			return restart();
+			badHeader = true;
+			break;
 		}
 		if (_keyId != *(uint64*)ints) {
 			LOG(("TCP Error: bad auth_key_id %1 instead of %2 received").arg(_keyId).arg(*(uint64*)ints));
-			return restart();
+			badHeader = true;
+			break;
 		}
+		packets.push_back(std::move(intsBuffer));
+	}
+	auto decrypted = DecryptPackets(packets, _encryptionKey);
+	packets.clear();
 
+	for (auto &packet : decrypted) {
 		constexpr auto kMinPaddingSize = 12U;
 		constexpr auto kMaxPaddingSize = 1024U;
 
-		auto encryptedInts = ints + kExternalHeaderIntsCount;
-		auto encryptedIntsCount = (intsCount - kExternalHeaderIntsCount) & ~0x03U;
-		auto encryptedBytesCount = encryptedIntsCount * kIntSize;
-		auto decryptedBuffer = QByteArray(encryptedBytesCount, Qt::Uninitialized);
-		auto msgKey = *(MTPint128*)(ints + 2);
-
-		aesIgeDecrypt(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
-
+		const auto decryptedBuffer = std::move(packet.data);
+		const auto encryptedBytesCount = packet.encryptedBytesCount;
 		auto decryptedInts = reinterpret_cast<const mtpPrime*>(decryptedBuffer.constData());
 		auto serverSalt = *(uint64*)&decryptedInts[0];
 		auto session = *(uint64*)&decryptedInts[2];
@@ -1285,16 +1318,7 @@ void SessionPrivate::handleReceived() {
 		// Can underflow, but it is an unsigned type, so we just check the range later.
 		auto paddingSize = static_cast<uint32>(encryptedBytesCount) - static_cast<uint32>(fullDataLength);
 
-		std::array<uchar, 32> sha256Buffer = { { 0 } };
-
-		SHA256_CTX msgKeyLargeContext;
-		SHA256_Init(&msgKeyLargeContext);
-		SHA256_Update(&msgKeyLargeContext, _encryptionKey->partForMsgKey(false), 32);
-		SHA256_Update(&msgKeyLargeContext, decryptedInts, encryptedBytesCount);
-		SHA256_Final(sha256Buffer.data(), &msgKeyLargeContext);
-
-		constexpr auto kMsgKeyShift = 8U;
-		if (ConstTimeIsDifferent(&msgKey, sha256Buffer.data() + kMsgKeyShift, sizeof(msgKey))) {
+		if (!packet.verified) {
 			LOG(("TCP Error: bad SHA256 hash after aesDecrypt in message"));
 			return restart();
 		}
@@ -1411,6 +1435,9 @@ void SessionPrivate::handleReceived() {
 			}
 		}
 	}
+	if (badHeader) {
+		return restart();
+	}
 	if (_connection->needHttpWait()) {
 		_sessionData->queueSendAnything();
 	}
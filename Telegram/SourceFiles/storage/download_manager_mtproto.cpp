@@ -31,11 +31,38 @@ constexpr auto kRemoveSessionAfterTimeouts = 4;
 constexpr auto kResetDownloadPrioritiesTimeout = crl::time(200);
 constexpr auto kBadRequestDurationThreshold = 8 * crl::time(1000);
 
+// We request CDN file hashes for this many parts ahead of the requests.
+constexpr auto kCdnHashesPrefetchParts = 8;
+
 // Each (session remove by timeouts) we wait for time:
 // kRetryAddSessionTimeout * max(removesCount, kMaxTrackedSessionRemoves)
 // and for successes in all remaining sessions:
 // kRetryAddSessionSuccesses * max(removesCount, kMaxTrackedSessionRemoves)
 
+void DecryptCdnPart(
+		QByteArray &bytes,
+		const QByteArray &encryptionKey,
+		const QByteArray &encryptionIV,
+		int offset) {
+	auto key = bytes::make_span(encryptionKey);
+	auto iv = bytes::make_span(encryptionIV);
+	Expects(key.size() == MTP::CTRState::KeySize);
+	Expects(iv.size() == MTP::CTRState::IvecSize);
+
+	auto state = MTP::CTRState();
+	auto ivec = bytes::make_span(state.ivec);
+	std::copy(iv.begin(), iv.end(), ivec.begin());
+
+	auto counterOffset = static_cast<uint32>(offset) >> 4;
+	state.ivec[15] = static_cast<uchar>(counterOffset & 0xFF);
+	state.ivec[14] = static_cast<uchar>((counterOffset >> 8) & 0xFF);
+	state.ivec[13] = static_cast<uchar>((counterOffset >> 16) & 0xFF);
+	state.ivec[12] = static_cast<uchar>((counterOffset >> 24) & 0xFF);
+
+	auto buffer = bytes::make_detached_span(bytes);
+	MTP::aesCtrEncrypt(buffer, key.data(), &state);
+}
+
 } // namespace
 
 void DownloadManagerMtproto::Queue::enqueue(
@@ -515,6 +542,7 @@ mtpRequestId DownloadMtprotoTask::sendRequest(
 		_cdnDcId ? _cdnDcId : dcId(),
 		requestData.sessionIndex);
 	if (_cdnDcId) {
+		prefetchCdnFileHashes(requestData);
 		return api().request(MTPupload_GetCdnFile(
 			MTP_bytes(_cdnToken),
 			MTP_int(offset),
@@ -581,11 +609,17 @@ void DownloadMtprotoTask::makeRequest(const RequestData &requestData) {
 }
 
 void DownloadMtprotoTask::requestMoreCdnFileHashes() {
-	if (_cdnHashesRequestId || _cdnUncheckedParts.empty()) {
+	if (_cdnHashesRequestId || _cdnHashesPrefetchRequestId) {
+		return;
+	}
+	const auto i = ranges::find_if(_cdnUncheckedParts, [&](const auto &p) {
+		return !_cdnFileHashes.contains(p.first.offset);
+	});
+	if (i == end(_cdnUncheckedParts)) {
 		return;
 	}
 
-	const auto requestData = _cdnUncheckedParts.cbegin()->first;
+	const auto requestData = i->first;
 	const auto shiftedDcId = MTP::downloadDcId(
 		dcId(),
 		requestData.sessionIndex);
@@ -600,6 +634,47 @@ void DownloadMtprotoTask::requestMoreCdnFileHashes() {
 	placeSentRequest(_cdnHashesRequestId, requestData);
 }
 
+void DownloadMtprotoTask::prefetchCdnFileHashes(
+		const RequestData &requestData) {
+	if (_cdnHashesRequestId || _cdnHashesPrefetchRequestId) {
+		return;
+	}
+	auto from = -1;
+	for (auto i = 0; i != kCdnHashesPrefetchParts; ++i) {
+		const auto offset = requestData.offset + i * kDownloadPartSize;
+		if (!_cdnFileHashes.contains(offset)) {
+			from = offset;
+			break;
+		}
+	}
+	if (from < 0) {
+		return;
+	}
+	const auto shiftedDcId = MTP::downloadDcId(
+		dcId(),
+		requestData.sessionIndex);
+	_cdnHashesPrefetchRequestId = api().request(MTPupload_GetCdnFileHashes(
+		MTP_bytes(_cdnToken),
+		MTP_int(from)
+	)).done([=](const MTPVector<MTPFileHash> &result) {
+		_cdnHashesPrefetchRequestId = 0;
+		addCdnHashes(result.v);
+		if (feedCheckedCdnParts()) {
+			requestMoreCdnFileHashes();
+		}
+	}).fail([=] {
+		// Not critical, we'll request the hashes for the unchecked parts.
+		_cdnHashesPrefetchRequestId = 0;
+		requestMoreCdnFileHashes();
+	}).toDC(shiftedDcId).send();
+}
+
+void DownloadMtprotoTask::cancelCdnFileHashesPrefetch() {
+	if (const auto requestId = base::take(_cdnHashesPrefetchRequestId)) {
+		api().request(requestId).cancel();
+	}
+}
+
 void DownloadMtprotoTask::normalPartLoaded(
 		const MTPupload_File &result,
 		mtpRequestId requestId) {
@@ -664,53 +739,86 @@ void DownloadMtprotoTask::cdnPartLoaded(const MTPupload_CdnFile &result, mtpRequ
 			owner->checkSendNextAfterSuccess(dcId);
 		});
 
-		auto key = bytes::make_span(_cdnEncryptionKey);
-		auto iv = bytes::make_span(_cdnEncryptionIV);
-		Expects(key.size() == MTP::CTRState::KeySize);
-		Expects(iv.size() == MTP::CTRState::IvecSize);
-
-		auto state = MTP::CTRState();
-		auto ivec = bytes::make_span(state.ivec);
-		std::copy(iv.begin(), iv.end(), ivec.begin());
+		// The part is decrypted and hashed on a worker thread, meanwhile
+		// it is kept in unchecked parts, so that it won't be requested.
+		_cdnUncheckedParts.emplace(requestData, CdnUncheckedPart());
+		crl::async([
+			=,
+			weak = base::make_weak(this),
+			bytes = data.vbytes().v,
+			key = _cdnEncryptionKey,
+			iv = _cdnEncryptionIV,
+			offset = requestData.offset
+		]() mutable {
+			DecryptCdnPart(bytes, key, iv, offset);
+			auto hash = openssl::Sha256(bytes::make_span(bytes));
+			crl::on_main(weak, [
+				=,
+				bytes = std::move(bytes),
+				hash = std::move(hash)
+			]() mutable {
+				cdnPartDecrypted(offset, std::move(bytes), std::move(hash));
+			});
+		});
+	});
+}
 
-		auto counterOffset = static_cast<uint32>(requestData.offset) >> 4;
-		state.ivec[15] = static_cast<uchar>(counterOffset & 0xFF);
-		state.ivec[14] = static_cast<uchar>((counterOffset >> 8) & 0xFF);
-		state.ivec[13] = static_cast<uchar>((counterOffset >> 16) & 0xFF);
-		state.ivec[12] = static_cast<uchar>((counterOffset >> 24) & 0xFF);
+void DownloadMtprotoTask::cdnPartDecrypted(
+		int offset,
+		QByteArray &&bytes,
+		bytes::vector &&hash) {
+	const auto i = _cdnUncheckedParts.find({ offset, 0 });
+	if (i == end(_cdnUncheckedParts) || !i->second.hash.empty()) {
+		return;
+	}
+	i->second.bytes = std::move(bytes);
+	i->second.hash = std::move(hash);
+	if (feedCheckedCdnParts()) {
+		requestMoreCdnFileHashes();
+	}
+}
 
-		auto decryptInPlace = data.vbytes().v;
-		auto buffer = bytes::make_detached_span(decryptInPlace);
-		MTP::aesCtrEncrypt(buffer, key.data(), &state);
+bool DownloadMtprotoTask::feedCheckedCdnParts() {
+	for (auto i = _cdnUncheckedParts.begin(); i != _cdnUncheckedParts.cend();) {
+		const auto uncheckedOffset = i->first.offset;
 
-		switch (checkCdnFileHash(requestData.offset, buffer)) {
+		switch (checkCdnFileHash(uncheckedOffset, i->second.hash)) {
 		case CheckCdnHashResult::NoHash: {
-			_cdnUncheckedParts.emplace(requestData, decryptInPlace);
-			requestMoreCdnFileHashes();
-		} return;
+			++i;
+		} break;
 
 		case CheckCdnHashResult::Invalid: {
 			LOG(("API Error: Wrong cdnFileHash for offset %1."
-				).arg(requestData.offset));
+				).arg(uncheckedOffset));
 			cancelOnFail();
-		} return;
+			return false;
+		} break;
 
 		case CheckCdnHashResult::Good: {
-			partLoaded(requestData.offset, decryptInPlace);
-		} return;
+			const auto goodBytes = std::move(i->second.bytes);
+			const auto weak = base::make_weak(this);
+			i = _cdnUncheckedParts.erase(i);
+			if (!feedPart(uncheckedOffset, goodBytes) || !weak) {
+				return false;
+			}
+		} break;
+
+		default: Unexpected("Result of checkCdnFileHash()");
 		}
-		Unexpected("Result of checkCdnFileHash()");
-	});
+	}
+	return true;
 }
 
 DownloadMtprotoTask::CheckCdnHashResult DownloadMtprotoTask::checkCdnFileHash(
 		int offset,
-		bytes::const_span buffer) {
+		bytes::const_span realHash) {
+	if (realHash.empty()) {
+		return CheckCdnHashResult::NoHash; // Not computed yet.
+	}
 	const auto cdnFileHashIt = _cdnFileHashes.find(offset);
 	if (cdnFileHashIt == _cdnFileHashes.cend()) {
 		return CheckCdnHashResult::NoHash;
 	}
-	const auto realHash = openssl::Sha256(buffer);
 	const auto receivedHash = bytes::make_span(cdnFileHashIt->second.hash);
 	if (bytes::compare(realHash, receivedHash)) {
 		return CheckCdnHashResult::Invalid;
@@ -737,44 +845,15 @@ void DownloadMtprotoTask::getCdnFileHashesDone(
 		requestId,
 		FinishRequestReason::Redirect);
 	addCdnHashes(result.v);
-	auto someMoreChecked = false;
-	for (auto i = _cdnUncheckedParts.begin(); i != _cdnUncheckedParts.cend();) {
-		const auto uncheckedData = i->first;
-		const auto uncheckedBytes = bytes::make_span(i->second);
-
-		switch (checkCdnFileHash(uncheckedData.offset, uncheckedBytes)) {
-		case CheckCdnHashResult::NoHash: {
-			++i;
-		} break;
-
-		case CheckCdnHashResult::Invalid: {
-			LOG(("API Error: Wrong cdnFileHash for offset %1."
-				).arg(uncheckedData.offset));
-			cancelOnFail();
-			return;
-		} break;
-
-		case CheckCdnHashResult::Good: {
-			someMoreChecked = true;
-			const auto goodOffset = uncheckedData.offset;
-			const auto goodBytes = std::move(i->second);
-			const auto weak = base::make_weak(this);
-			i = _cdnUncheckedParts.erase(i);
-			if (!feedPart(goodOffset, goodBytes) || !weak) {
-				return;
-			}
-		} break;
-
-		default: Unexpected("Result of checkCdnFileHash()");
-		}
-	}
-	if (!someMoreChecked) {
+	if (!_cdnFileHashes.contains(requestData.offset)) {
 		LOG(("API Error: "
 			"Could not find cdnFileHash for offset %1 "
 			"after getCdnFileHashes request."
 			).arg(requestData.offset));
 		cancelOnFail();
 		return;
+	} else if (!feedCheckedCdnParts()) {
+		return;
 	}
 	requestMoreCdnFileHashes();
 }
@@ -840,6 +919,7 @@ void DownloadMtprotoTask::cancelAllRequests() {
 	while (!_sentRequests.empty()) {
 		cancelRequest(_sentRequests.begin()->first);
 	}
+	cancelCdnFileHashesPrefetch();
 	_cdnUncheckedParts.clear();
 }
 
@@ -981,6 +1061,9 @@ void DownloadMtprotoTask::changeCDNParams(
 	_cdnEncryptionIV = encryptionIV;
 	addCdnHashes(hashes);
 
+	if (resendAllRequests) {
+		cancelCdnFileHashesPrefetch();
+	}
 	if (resendAllRequests && !_sentRequests.empty()) {
 		auto resendRequests = std::vector<RequestData>();
 		resendRequests.reserve(_sentRequests.size());
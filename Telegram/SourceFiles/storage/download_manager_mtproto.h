@@ -178,6 +178,10 @@ private:
 			return offset < other.offset;
 		}
 	};
+	struct CdnUncheckedPart {
+		QByteArray bytes;
+		bytes::vector hash; // Empty while being computed.
+	};
 	struct CdnFileHash {
 		CdnFileHash(int limit, QByteArray hash) : limit(limit), hash(hash) {
 		}
@@ -215,7 +219,14 @@ private:
 	void reuploadDone(
 		const MTPVector<MTPFileHash> &result,
 		mtpRequestId requestId);
+	void cdnPartDecrypted(
+		int offset,
+		QByteArray &&bytes,
+		bytes::vector &&hash);
+	[[nodiscard]] bool feedCheckedCdnParts();
 	void requestMoreCdnFileHashes();
+	void prefetchCdnFileHashes(const RequestData &requestData);
+	void cancelCdnFileHashesPrefetch();
 	void getCdnFileHashesDone(
 		const MTPVector<MTPFileHash> &result,
 		mtpRequestId requestId);
@@ -250,7 +261,7 @@ private:
 
 	[[nodiscard]] CheckCdnHashResult checkCdnFileHash(
 		int offset,
-		bytes::const_span buffer);
+		bytes::const_span realHash);
 
 	const not_null<DownloadManagerMtproto*> _owner;
 	const MTP::DcId _dcId = 0;
@@ -267,8 +278,9 @@ private:
 	QByteArray _cdnEncryptionKey;
 	QByteArray _cdnEncryptionIV;
 	base::flat_map<int, CdnFileHash> _cdnFileHashes;
-	base::flat_map<RequestData, QByteArray> _cdnUncheckedParts;
+	base::flat_map<RequestData, CdnUncheckedPart> _cdnUncheckedParts;
 	mtpRequestId _cdnHashesRequestId = 0;
+	mtpRequestId _cdnHashesPrefetchRequestId = 0;
 
 };
 
@@ -22,9 +22,40 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "apiwrap.h"
 #include "core/crash_reports.h"
 #include "base/bytes.h"
+#include "base/openssl_help.h"
+#include "base/unixtime.h"
 
 namespace {
 
+// Save the partial download journal after each 4 MB of loaded data.
+constexpr auto kPartialDownloadJournalStep = 4 * 1024 * 1024;
+
+// The last downloaded part is hashed in the journal and checked against
+// the file contents when the download is resumed.
+[[nodiscard]] std::pair<int, int> PartialTail(int loaded) {
+	const auto size = std::min(loaded, Storage::kDownloadPartSize);
+	return { loaded - size, size };
+}
+
+[[nodiscard]] QByteArray PartialTailHash(const QByteArray &tail) {
+	const auto hash = openssl::Sha256(bytes::make_span(tail));
+	return QByteArray(
+		reinterpret_cast<const char*>(hash.data()),
+		hash.size());
+}
+
+[[nodiscard]] QByteArray ReadPartialTailHash(
+		const QString &path,
+		int loaded) {
+	QFile file(path);
+	const auto [offset, size] = PartialTail(loaded);
+	if (!file.open(QIODevice::ReadOnly) || !file.seek(offset)) {
+		return QByteArray();
+	}
+	const auto tail = file.read(size);
+	return (tail.size() == size) ? PartialTailHash(tail) : QByteArray();
+}
+
 class FromMemoryLoader final : public FileLoader {
 public:
 	FromMemoryLoader(
@@ -254,14 +285,164 @@ bool FileLoader::checkForOpen() {
 		|| _fileIsOpen) {
 		return true;
 	}
-	_fileIsOpen = _file.open(QIODevice::WriteOnly);
+	const auto resumed = resumePartialDownload();
+	if (_partialKey) {
+		_file.setFileName(Storage::PartialDownloadFilePath(_filename));
+	}
+	_fileIsOpen = _file.open(resumed
+		? QIODevice::ReadWrite
+		: QIODevice::WriteOnly);
 	if (_fileIsOpen) {
+		if (resumed && _file.resize(resumed)) {
+			_resumedBytes = resumed;
+			_partialRanges.emplace_back(0, resumed);
+			_partialWrittenTill = resumed;
+		} else if (resumed) {
+			_file.resize(0);
+		}
 		return true;
 	}
 	cancel(true);
 	return false;
 }
 
+int FileLoader::resumePartialDownload() {
+	const auto key = fileLocationKey();
+	if (!key || _fullSize <= Storage::kMaxFileInMemory) {
+		return 0;
+	}
+	_partialKey = key;
+
+	// Besides the sizes only the last loaded part is checked here, there
+	// is no way to verify all the contents without downloading them again.
+	auto &local = _session->local();
+	const auto partial = local.readPartialDownload(*key);
+	if (!partial) {
+		return 0;
+	}
+	const auto loaded = (!partial->ranges.empty()
+		&& !partial->ranges.front().first)
+		? std::min(partial->ranges.front().second, _fullSize)
+		: 0;
+	const auto was = Storage::PartialDownloadFilePath(partial->path);
+	const auto now = Storage::PartialDownloadFilePath(_filename);
+	const auto size = QFileInfo(was).size();
+	const auto good = (partial->fullSize == _fullSize)
+		&& (loaded > 0)
+		&& (size >= loaded)
+		&& !partial->tailHash.isEmpty()
+		&& (ReadPartialTailHash(was, loaded) == partial->tailHash);
+	if (!good) {
+		local.removePartialDownload(*key);
+		QFile::remove(was);
+		return 0;
+	} else if (was != now) {
+		QFile::remove(now);
+		if (!QFile::rename(was, now)) {
+			local.removePartialDownload(*key);
+			QFile::remove(was);
+			return 0;
+		}
+	}
+	LOG(("Download Info: Resuming '%1' from %2 of %3."
+		).arg(_filename
+		).arg(loaded
+		).arg(_fullSize));
+	return loaded;
+}
+
+void FileLoader::addPartialRange(int from, int till) {
+	const auto i = ranges::lower_bound(
+		_partialRanges,
+		from,
+		ranges::less(),
+		&std::pair<int, int>::second);
+	auto j = i;
+	while (j != end(_partialRanges) && j->first <= till) {
+		from = std::min(from, j->first);
+		till = std::max(till, j->second);
+		++j;
+	}
+	if (i == j) {
+		_partialRanges.insert(i, { from, till });
+	} else {
+		*i = { from, till };
+		_partialRanges.erase(i + 1, j);
+	}
+	const auto &first = _partialRanges.front();
+	const auto loaded = first.first ? 0 : first.second;
+	if (loaded >= _partialWrittenTill + kPartialDownloadJournalStep) {
+		writePartialDownload();
+	}
+}
+
+bool FileLoader::writePartialDownload() {
+	if (!_partialKey
+		|| !_fileIsOpen
+		|| _partialRanges.empty()
+		|| !_file.flush()) {
+		return false;
+	}
+	const auto &first = _partialRanges.front();
+	const auto loaded = first.first ? 0 : first.second;
+	if (!loaded) {
+		return false;
+	}
+	const auto [offset, size] = PartialTail(loaded);
+	const auto tail = readLoadedPartBack(offset, size);
+	if (tail.isEmpty()) {
+		return false;
+	}
+	_partialWrittenTill = loaded;
+	_session->local().writePartialDownload(*_partialKey, {
+		.path = _filename,
+		.fullSize = _fullSize,
+		.ranges = _partialRanges,
+		.tailHash = PartialTailHash(tail),
+		.updated = base::unixtime::now(),
+	});
+	return true;
+}
+
+bool FileLoader::movePartialFile() {
+	if (!_fileIsOpen || _file.fileName() == _filename) {
+		return true;
+	}
+	_file.close();
+	QFile::remove(_filename);
+	if (_file.rename(_filename) && _file.open(QIODevice::ReadWrite)) {
+		return true;
+	}
+	_fileIsOpen = false;
+	_file.remove();
+	return false;
+}
+
+void FileLoader::removePartialDownload() {
+	if (const auto key = base::take(_partialKey)) {
+		_session->local().removePartialDownload(*key);
+	}
+}
+
+bool FileLoader::stopKeepingPartial() {
+	Expects(!_finished);
+
+	if (!writePartialDownload()) {
+		// Nothing to resume from, the temporary file will be removed
+		// by cancel(), unless reading the file back has cancelled already.
+		return _finished;
+	}
+	cancelHook();
+
+	_cancelled = true;
+	_finished = true;
+	_file.close();
+	_fileIsOpen = false;
+	_data = QByteArray();
+	_updates.fire_done();
+	return true;
+}
+
 void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 	const auto readImage = (_locationType != AudioFileLocation);
 	auto done = [=, guard = _localLoading.make_guard()](
@@ -336,6 +517,7 @@ void FileLoader::cancel(bool fail) {
 	const auto started = (currentOffset() > 0);
 
 	cancelHook();
+	removePartialDownload();
 
 	_cancelled = true;
 	_finished = true;
@@ -380,6 +562,9 @@ bool FileLoader::writeResultPart(int offset, bytes::const_span buffer) {
 			cancel(true);
 			return false;
 		}
+		if (_partialKey) {
+			addPartialRange(offset, offset + buffer.size());
+		}
 		return true;
 	}
 	_data.reserve(offset + buffer.size());
@@ -439,6 +624,12 @@ bool FileLoader::finalizeResult() {
 		}
 	}
 
+	if (!movePartialFile()) {
+		cancel(true);
+		return false;
+	}
+	removePartialDownload();
+
 	_finished = true;
 	if (_fileIsOpen) {
 		_file.close();
@@ -133,6 +133,12 @@ protected:
 
 	void readImage(int progressiveSizeLimit) const;
 
+	[[nodiscard]] int resumePartialDownload();
+	void addPartialRange(int from, int till);
+	bool writePartialDownload();
+	void removePartialDownload();
+	[[nodiscard]] bool movePartialFile();
+
 	bool checkForOpen();
 	bool tryLoadLocal();
 	void loadLocal(const Storage::Cache::Key &key);
@@ -150,6 +156,7 @@ protected:
 
 	bool writeResultPart(int offset, bytes::const_span buffer);
 	bool finalizeResult();
+	bool stopKeepingPartial();
 	[[nodiscard]] QByteArray readLoadedPartBack(int offset, int size);
 
 	const not_null<Main::Session*> _session;
@@ -172,8 +179,13 @@ protected:
 	int _loadSize = 0;
 	int _fullSize = 0;
 	int _skippedBytes = 0;
+	int _resumedBytes = 0;
 	LocationType _locationType = LocationType();
 
+	std::optional<MediaKey> _partialKey;
+	std::vector<std::pair<int, int>> _partialRanges;
+	int _partialWrittenTill = 0;
+
 	base::binary_guard _localLoading;
 	mutable QByteArray _imageFormat;
 	mutable QImage _imageData;
@@ -90,7 +90,7 @@ mtpFileLoader::mtpFileLoader(
 }
 
 mtpFileLoader::~mtpFileLoader() {
-	if (!_finished) {
+	if (!_finished && !stopKeepingPartial()) {
 		cancel();
 	}
 }
@@ -157,6 +157,14 @@ bool mtpFileLoader::setWebFileSizeHook(int size) {
 }
 
 void mtpFileLoader::startLoading() {
+	if (_resumedBytes > _nextRequestOffset) {
+		const auto parts = _resumedBytes / Storage::kDownloadPartSize;
+		_nextRequestOffset = parts * Storage::kDownloadPartSize;
+		if (_fullSize && _resumedBytes >= _loadSize) {
+			finalizeResult();
+			return;
+		}
+	}
 	addToQueue();
 }
 
@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/serialize_common.h"
 #include "storage/serialize_peer.h"
 #include "storage/serialize_document.h"
+#include "base/unixtime.h"
 #include "main/main_account.h"
 #include "main/main_session.h"
 #include "mtproto/mtproto_config.h"
@@ -40,6 +41,7 @@ using namespace details;
 using Database = Cache::Database;
 
 constexpr auto kDelayedWriteTimeout = crl::time(1000);
+constexpr auto kPartialDownloadLifetime = TimeId(7 * 24 * 60 * 60);
 
 constexpr auto kStickersVersionTag = quint32(-1);
 constexpr auto kStickersSerializeVersion = 2;
@@ -83,6 +85,7 @@ enum { // Local Storage Keys
 	lskBackgroundOld = 0x14, // no data
 	lskSelfSerialized = 0x15, // serialized self
 	lskMasksKeys = 0x16, // no data
+	lskPartialDownloads = 0x17, // no data
 };
 
 auto EmptyMessageDraftSources()
@@ -133,10 +136,14 @@ Account::Account(not_null<Main::Account*> owner, const QString &dataName)
 , _cacheTotalTimeLimit(Database::Settings().totalTimeLimit)
 , _cacheBigFileTotalTimeLimit(Database::Settings().totalTimeLimit)
 , _writeMapTimer([=] { writeMap(); })
-, _writeLocationsTimer([=] { writeLocations(); }) {
+, _writeLocationsTimer([=] { writeLocations(); })
+, _writePartialDownloadsTimer([=] { writePartialDownloads(); }) {
 }
 
 Account::~Account() {
+	if (_localKey && _partialDownloadsChanged) {
+		writePartialDownloads();
+	}
 	if (_localKey && _mapChanged) {
 		writeMap();
 	}
@@ -202,6 +209,7 @@ base::flat_set<QString> Account::collectGoodNames() const {
 		_installedMasksKey,
 		_recentMasksKey,
 		_archivedMasksKey,
+		_partialDownloadsKey,
 	};
 	auto result = base::flat_set<QString>{
 		"map0",
@@ -286,6 +294,7 @@ Account::ReadMapResult Account::readMapWith(
 	quint64 savedGifsKey = 0;
 	quint64 legacyBackgroundKeyDay = 0, legacyBackgroundKeyNight = 0;
 	quint64 userSettingsKey = 0, recentHashtagsAndBotsKey = 0, exportSettingsKey = 0;
+	quint64 partialDownloadsKey = 0;
 	while (!map.stream.atEnd()) {
 		quint32 keyType;
 		map.stream >> keyType;
@@ -385,6 +394,9 @@ Account::ReadMapResult Account::readMapWith(
 				>> recentMasksKey
 				>> archivedMasksKey;
 		} break;
+		case lskPartialDownloads: {
+			map.stream >> partialDownloadsKey;
+		} break;
 		default:
 			LOG(("App Error: unknown key type in encrypted map: %1").arg(keyType));
 			return ReadMapResult::Failed;
@@ -417,6 +429,7 @@ Account::ReadMapResult Account::readMapWith(
 	_settingsKey = userSettingsKey;
 	_recentHashtagsAndBotsKey = recentHashtagsAndBotsKey;
 	_exportSettingsKey = exportSettingsKey;
+	_partialDownloadsKey = partialDownloadsKey;
 	_oldMapVersion = mapData.version;
 
 	if (_oldMapVersion < AppVersion) {
@@ -428,6 +441,9 @@ Account::ReadMapResult Account::readMapWith(
 	if (_locationsKey) {
 		readLocations();
 	}
+	if (_partialDownloadsKey) {
+		readPartialDownloads();
+	}
 	if (_legacyBackgroundKeyDay || _legacyBackgroundKeyNight) {
 		Local::moveLegacyBackground(
 			_basePath,
@@ -519,6 +535,7 @@ void Account::writeMap() {
 	if (_installedMasksKey || _recentMasksKey || _archivedMasksKey) {
 		mapSize += sizeof(quint32) + 3 * sizeof(quint64);
 	}
+	if (_partialDownloadsKey) mapSize += sizeof(quint32) + sizeof(quint64);
 
 	EncryptedDescriptor mapData(mapSize);
 	if (!self.isEmpty()) {
@@ -571,6 +588,9 @@ void Account::writeMap() {
 			<< quint64(_recentMasksKey)
 			<< quint64(_archivedMasksKey);
 	}
+	if (_partialDownloadsKey) {
+		mapData.stream << quint32(lskPartialDownloads) << quint64(_partialDownloadsKey);
+	}
 	map.writeEncrypted(mapData, _localKey);
 
 	_mapChanged = false;
@@ -594,10 +614,18 @@ void Account::reset() {
 	_archivedMasksKey = 0;
 	_legacyBackgroundKeyDay = _legacyBackgroundKeyNight = 0;
 	_settingsKey = _recentHashtagsAndBotsKey = _exportSettingsKey = 0;
+	_partialDownloadsKey = 0;
 	_oldMapVersion = 0;
 	_fileLocations.clear();
 	_fileLocationPairs.clear();
 	_fileLocationAliases.clear();
+	auto partialFiles = std::vector<QString>();
+	partialFiles.reserve(_partialDownloads.size());
+	for (const auto &[location, partial] : base::take(_partialDownloads)) {
+		partialFiles.push_back(PartialDownloadFilePath(partial.path));
+	}
+	_partialDownloadsChanged = false;
+	_writePartialDownloadsTimer.cancel();
 	_cacheTotalSizeLimit = Database::Settings().totalSizeLimit;
 	_cacheTotalTimeLimit = Database::Settings().totalTimeLimit;
 	_cacheBigFileTotalSizeLimit = Database::Settings().totalSizeLimit;
@@ -606,7 +634,15 @@ void Account::reset() {
 	writeMap();
 	writeMtpData();
 
-	crl::async([base = _basePath, temp = _tempPath, names = std::move(names)] {
+	crl::async([
+		base = _basePath,
+		temp = _tempPath,
+		names = std::move(names),
+		partialFiles = std::move(partialFiles)
+	] {
+		for (const auto &path : partialFiles) {
+			QFile::remove(path);
+		}
 		for (const auto &name : names) {
 			if (!name.endsWith(qstr("map0"))
 				&& !name.endsWith(qstr("map1"))
@@ -761,6 +797,120 @@ void Account::readLocations() {
 	}
 }
 
+void Account::writePartialDownloads() {
+	_writePartialDownloadsTimer.cancel();
+	if (!_partialDownloadsChanged) {
+		return;
+	}
+	_partialDownloadsChanged = false;
+
+	if (_partialDownloads.empty()) {
+		if (_partialDownloadsKey) {
+			ClearKey(_partialDownloadsKey, _basePath);
+			_partialDownloadsKey = 0;
+			writeMapDelayed();
+		}
+		return;
+	}
+	if (!_partialDownloadsKey) {
+		_partialDownloadsKey = GenerateKey(_basePath);
+		writeMapQueued();
+	}
+	quint32 size = sizeof(quint32);
+	for (const auto &[location, partial] : _partialDownloads) {
+		// location + path + full size + ranges + tail hash + updated
+		size += sizeof(quint64) * 2
+			+ Serialize::stringSize(partial.path)
+			+ sizeof(qint32)
+			+ sizeof(quint32)
+			+ partial.ranges.size() * sizeof(qint32) * 2
+			+ Serialize::bytearraySize(partial.tailHash)
+			+ sizeof(qint32);
+	}
+
+	EncryptedDescriptor data(size);
+	data.stream << quint32(_partialDownloads.size());
+	for (const auto &[location, partial] : _partialDownloads) {
+		data.stream
+			<< quint64(location.first)
+			<< quint64(location.second)
+			<< partial.path
+			<< qint32(partial.fullSize)
+			<< quint32(partial.ranges.size());
+		for (const auto &[from, till] : partial.ranges) {
+			data.stream << qint32(from) << qint32(till);
+		}
+		data.stream << partial.tailHash << qint32(partial.updated);
+	}
+
+	FileWriteDescriptor file(_partialDownloadsKey, _basePath);
+	file.writeEncrypted(data, _localKey);
+}
+
+void Account::writePartialDownloadsDelayed() {
+	_partialDownloadsChanged = true;
+	_writePartialDownloadsTimer.callOnce(kDelayedWriteTimeout);
+}
+
+void Account::readPartialDownloads() {
+	FileReadDescriptor partials;
+	if (!ReadEncryptedFile(partials, _partialDownloadsKey, _basePath, _localKey)) {
+		ClearKey(_partialDownloadsKey, _basePath);
+		_partialDownloadsKey = 0;
+		writeMapDelayed();
+		return;
+	}
+
+	const auto now = base::unixtime::now();
+	auto stale = std::vector<QString>();
+	const auto guard = gsl::finally([&] {
+		if (stale.empty()) {
+			return;
+		}
+		writePartialDownloadsDelayed();
+		crl::async([stale = std::move(stale)] {
+			for (const auto &path : stale) {
+				QFile::remove(path);
+			}
+		});
+	});
+
+	quint32 count = 0;
+	partials.stream >> count;
+	for (quint32 i = 0; i != count; ++i) {
+		quint64 first = 0, second = 0;
+		qint32 fullSize = 0;
+		quint32 rangesCount = 0;
+		auto partial = PartialDownload();
+		partials.stream >> first >> second >> partial.path >> fullSize >> rangesCount;
+		if (!CheckStreamStatus(partials.stream)) {
+			return;
+		}
+		partial.fullSize = fullSize;
+		partial.ranges.reserve(rangesCount);
+		for (quint32 j = 0; j != rangesCount; ++j) {
+			qint32 from = 0, till = 0;
+			partials.stream >> from >> till;
+			partial.ranges.emplace_back(from, till);
+		}
+		qint32 updated = 0;
+		partials.stream >> partial.tailHash >> updated;
+		if (!CheckStreamStatus(partials.stream)) {
+			return;
+		}
+		partial.updated = updated;
+
+		// Downloads that were not resumed for a long time are dropped.
+		const auto file = PartialDownloadFilePath(partial.path);
+		if (partial.updated + kPartialDownloadLifetime < now
+			|| !QFile::exists(file)) {
+			stale.push_back(file);
+			continue;
+		}
+		_partialDownloads.emplace(MediaKey(first, second), std::move(partial));
+	}
+}
+
 void Account::writeSessionSettings() {
 	writeSessionSettings(nullptr);
 }
@@ -1485,6 +1635,31 @@ void Account::removeFileLocation(MediaKey location) {
 	writeLocationsQueued();
 }
 
+QString PartialDownloadFilePath(const QString &path) {
+	return path + u".part"_q;
+}
+
+void Account::writePartialDownload(
+		MediaKey location,
+		const PartialDownload &partial) {
+	_partialDownloads[location] = partial;
+	writePartialDownloadsDelayed();
+}
+
+std::optional<PartialDownload> Account::readPartialDownload(
+		MediaKey location) const {
+	const auto i = _partialDownloads.find(location);
+	return (i != end(_partialDownloads))
+		? std::make_optional(i->second)
+		: std::nullopt;
+}
+
+void Account::removePartialDownload(MediaKey location) {
+	if (_partialDownloads.remove(location)) {
+		writePartialDownloadsDelayed();
+	}
+}
+
 Core::FileLocation Account::readFileLocation(MediaKey location) {
 	const auto aliasIt = _fileLocationAliases.constFind(location);
 	if (aliasIt != _fileLocationAliases.cend()) {
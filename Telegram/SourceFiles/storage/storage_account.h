@@ -61,6 +61,18 @@ struct MessageDraftSource {
 	Fn<MessageCursor()> cursor;
 };
 
+struct PartialDownload {
+	QString path;
+	int fullSize = 0;
+	std::vector<std::pair<int, int>> ranges; // Sorted [from, till) ranges.
+	QByteArray tailHash; // Hash of the last part of the first range.
+	TimeId updated = 0;
+};
+
+// Unfinished downloads are kept under a temporary name,
+// so that a truncated file never appears at the target path.
+[[nodiscard]] QString PartialDownloadFilePath(const QString &path);
+
 class Account final {
 public:
 	Account(not_null<Main::Account*> owner, const QString &dataName);
@@ -101,6 +113,13 @@ public:
 	[[nodiscard]] Core::FileLocation readFileLocation(MediaKey location);
 	void removeFileLocation(MediaKey location);
 
+	void writePartialDownload(
+		MediaKey location,
+		const PartialDownload &partial);
+	[[nodiscard]] std::optional<PartialDownload> readPartialDownload(
+		MediaKey location) const;
+	void removePartialDownload(MediaKey location);
+
 	[[nodiscard]] EncryptionKey cacheKey() const;
 	[[nodiscard]] QString cachePath() const;
 	[[nodiscard]] Cache::Database::Settings cacheSettings() const;
@@ -195,6 +214,10 @@ private:
 	void writeLocationsQueued();
 	void writeLocationsDelayed();
 
+	void readPartialDownloads();
+	void writePartialDownloads();
+	void writePartialDownloadsDelayed();
+
 	std::unique_ptr<Main::SessionSettings> readSessionSettings();
 	void writeSessionSettings(Main::SessionSettings *stored);
 
@@ -255,8 +278,10 @@ private:
 	QMultiMap<MediaKey, Core::FileLocation> _fileLocations;
 	QMap<QString, QPair<MediaKey, Core::FileLocation>> _fileLocationPairs;
 	QMap<MediaKey, MediaKey> _fileLocationAliases;
+	base::flat_map<MediaKey, PartialDownload> _partialDownloads;
 
 	FileKey _locationsKey = 0;
+	FileKey _partialDownloadsKey = 0;
 	FileKey _trustedBotsKey = 0;
 	FileKey _installedStickersKey = 0;
 	FileKey _featuredStickersKey = 0;
@@ -288,8 +313,10 @@ private:
 
 	base::Timer _writeMapTimer;
 	base::Timer _writeLocationsTimer;
+	base::Timer _writePartialDownloadsTimer;
 	bool _mapChanged = false;
 	bool _locationsChanged = false;
+	bool _partialDownloadsChanged = false;
 
 };
 
@@ -85,6 +85,63 @@ void PrepareDetailsInParallel(PreparedList &result, int previewWidth) {
 	semaphore.acquire(result.files.size());
 }
 
+PreparedList PrepareFilesList(const QStringList &files) {
+	auto result = PreparedList();
+	result.files.reserve(files.size());
+	for (const auto &file : files) {
+		const auto fileinfo = QFileInfo(file);
+		const auto filesize = fileinfo.size();
+		if (fileinfo.isDir()) {
+			return {
+				PreparedList::Error::Directory,
+				file
+			};
+		} else if (filesize <= 0) {
+			return {
+				PreparedList::Error::EmptyFile,
+				file
+			};
+		} else if (filesize > kFileSizeLimit) {
+			return {
+				PreparedList::Error::TooLargeFile,
+				file
+			};
+		}
+		if (result.files.size() < Ui::MaxAlbumItems()) {
+			result.files.emplace_back(file);
+			result.files.back().size = filesize;
+		} else {
+			result.filesToProcess.emplace_back(file);
+			result.filesToProcess.back().size = filesize;
+		}
+	}
+	return result;
+}
+
+PreparedList PrepareFilesList(const QList<QUrl> &files) {
+	auto locals = QStringList();
+	locals.reserve(files.size());
+	for (const auto &url : files) {
+		if (!url.isLocalFile()) {
+			return {
+				PreparedList::Error::NonLocalUrl,
+				url.toDisplayString()
+			};
+		}
+		locals.push_back(Platform::File::UrlToLocal(url));
+	}
+	return PrepareFilesList(locals);
+}
+
+PreparedList DeferDetails(PreparedList &&list) {
+	list.filesToProcess.insert(
+		list.filesToProcess.begin(),
+		std::make_move_iterator(list.files.begin()),
+		std::make_move_iterator(list.files.end()));
+	list.files.clear();
+	return std::move(list);
+}
+
 } // namespace
 
 bool ValidatePhotoEditorMediaDragData(not_null<const QMimeData*> data) {
@@ -179,54 +236,25 @@ MimeDataState ComputeMimeDataState(const QMimeData *data) {
 }
 
 PreparedList PrepareMediaList(const QList<QUrl> &files, int previewWidth) {
-	auto locals = QStringList();
-	locals.reserve(files.size());
-	for (const auto &url : files) {
-		if (!url.isLocalFile()) {
-			return {
-				PreparedList::Error::NonLocalUrl,
-				url.toDisplayString()
-			};
-		}
-		locals.push_back(Platform::File::UrlToLocal(url));
-	}
-	return PrepareMediaList(locals, previewWidth);
+	auto result = PrepareFilesList(files);
+	PrepareDetailsInParallel(result, previewWidth);
+	return result;
 }
 
 PreparedList PrepareMediaList(const QStringList &files, int previewWidth) {
-	auto result = PreparedList();
-	result.files.reserve(files.size());
-	for (const auto &file : files) {
-		const auto fileinfo = QFileInfo(file);
-		const auto filesize = fileinfo.size();
-		if (fileinfo.isDir()) {
-			return {
-				PreparedList::Error::Directory,
-				file
-			};
-		} else if (filesize <= 0) {
-			return {
-				PreparedList::Error::EmptyFile,
-				file
-			};
-		} else if (filesize > kFileSizeLimit) {
-			return {
-				PreparedList::Error::TooLargeFile,
-				file
-			};
-		}
-		if (result.files.size() < Ui::MaxAlbumItems()) {
-			result.files.emplace_back(file);
-			result.files.back().size = filesize;
-		} else {
-			result.filesToProcess.emplace_back(file);
-			result.files.back().size = filesize;
-		}
-	}
+	auto result = PrepareFilesList(files);
 	PrepareDetailsInParallel(result, previewWidth);
 	return result;
 }
 
+PreparedList PrepareMediaListDeferred(const QList<QUrl> &files) {
+	return DeferDetails(PrepareFilesList(files));
+}
+
+PreparedList PrepareMediaListDeferred(const QStringList &files) {
+	return DeferDetails(PrepareFilesList(files));
+}
+
 PreparedList PrepareMediaFromImage(
 		QImage &&image,
 		QByteArray &&content,
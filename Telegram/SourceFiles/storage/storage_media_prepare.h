@@ -43,6 +43,13 @@ enum class MimeDataState {
 [[nodiscard]] Ui::PreparedList PrepareMediaList(
 	const QStringList &files,
 	int previewWidth);
+
+// Only checks the files, their details are not read. The SendFilesBox
+// prepares them one by one in the background while it is shown.
+[[nodiscard]] Ui::PreparedList PrepareMediaListDeferred(
+	const QList<QUrl> &files);
+[[nodiscard]] Ui::PreparedList PrepareMediaListDeferred(
+	const QStringList &files);
 [[nodiscard]] Ui::PreparedList PrepareMediaFromImage(
 	QImage &&image,
 	QByteArray &&content,